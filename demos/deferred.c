@@ -0,0 +1,171 @@
+#include "../glblas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+
+#define BUFFERS 8
+
+static int failures = 0;
+
+// lengths differ so fragment chains also break on buffer layout
+static const int sizes[BUFFERS] = { 1003, 1003, 2000, 517, 1003, 1003, 64, 1003 };
+
+typedef enum { SCAL, AXPY, COPY } kind_t;
+
+typedef struct {
+    kind_t kind;
+    int n;
+    float alpha;
+    int x, incx;
+    int y, incy;
+} op_t;
+
+static int n_ops = 0;
+static op_t ops[64];
+
+static void record(kind_t kind, int n, float alpha, int x, int incx, int y, int incy)
+{
+    ops[n_ops++] = (op_t){ kind, n, alpha, x, incx, y, incy };
+}
+
+// the kernels' N spans y: element e of x pairs with y[e * incy] for e * incy < n
+static void run_host(float *host[BUFFERS])
+{
+    for (int i = 0; i < n_ops; i++) {
+        op_t *op = &ops[i];
+        float *x = host[op->x], *y = host[op->y];
+        for (int e = 0; e * op->incy < op->n; e++) {
+            if (op->kind == SCAL)
+                y[e * op->incy] *= op->alpha;
+            else if (op->kind == AXPY)
+                y[e * op->incy] += op->alpha * x[e * op->incx];
+            else
+                y[e * op->incy] = x[e * op->incx];
+        }
+    }
+}
+
+static void run_device(glblasMemory_t buf[BUFFERS])
+{
+    for (int i = 0; i < n_ops; i++) {
+        op_t *op = &ops[i];
+        if (op->kind == SCAL)
+            assert(glblasSscal(op->n, op->alpha, buf[op->y], op->incy) == GLBLAS_STATUS_SUCCESS);
+        else if (op->kind == AXPY)
+            assert(glblasSaxpy(op->n, op->alpha, buf[op->x], op->incx, buf[op->y], op->incy) == GLBLAS_STATUS_SUCCESS);
+        else
+            assert(glblasScopy(op->n, buf[op->x], op->incx, buf[op->y], op->incy) == GLBLAS_STATUS_SUCCESS);
+    }
+}
+
+static void check(const char *name, float *expected[BUFFERS], float *got[BUFFERS])
+{
+    float err = 0.f;
+    for (int b = 0; b < BUFFERS; b++)
+        for (int i = 0; i < sizes[b]; i++)
+            err = fmaxf(err, fabsf(expected[b][i] - got[b][i]) / (1.f + fabsf(expected[b][i])));
+
+    printf("%-32s max error %g\n", name, err);
+    if (!(err <= 1e-5f))
+        failures++;
+}
+
+int main()
+{
+    // device buffers are laid out in rows of 128 texels
+    glblasStatus_t status;
+    glblasHandle_t ctx;
+
+    assert((status = glblasCreate(&ctx, 128, 128)) == GLBLAS_STATUS_SUCCESS);
+
+    // a chain reading what earlier calls in it wrote
+    record(COPY, 1003, 0.f, 0, 1, 1, 1);
+    record(AXPY, 1003, 2.f, 1, 1, 2, 1);
+    record(SCAL, 1003, .5f, 0, 1, 2, 1);
+    record(AXPY, 1003, -1.f, 2, 1, 0, 1);
+    record(COPY, 517, 0.f, 0, 1, 3, 1);
+    // x and y the same buffer
+    record(AXPY, 1003, 2.f, 4, 1, 4, 1);
+    // strided calls run on their own, between recorded ones
+    record(SCAL, 1003, 3.f, 0, 1, 0, 2);
+    record(AXPY, 1003, 1.f, 0, 1, 1, 1);
+    record(COPY, 1003, 0.f, 1, 2, 5, 3);
+    record(AXPY, 517, -.5f, 5, 1, 3, 1);
+    record(AXPY, 1003, .25f, 3, 2, 7, 1);
+    // longer than one chain and over more buffers than one chain holds
+    for (int i = 0; i < 24; i++) {
+        int x = i % BUFFERS, y = (i * 3 + 1) % BUFFERS;
+        int n = sizes[x] < sizes[y] ? sizes[x] : sizes[y];
+        record(i % 3 == 0 ? SCAL : i % 3 == 1 ? AXPY : COPY, n, i % 2 ? .75f : -1.25f, x, 1, y, 1);
+    }
+    // the same buffer copied onto itself and a unit scale that's skipped
+    record(COPY, 1003, 0.f, 7, 1, 7, 1);
+    record(SCAL, 1003, 1.f, 0, 1, 7, 1);
+
+    float *initial[BUFFERS], *expected[BUFFERS], *immediate[BUFFERS], *deferred[BUFFERS];
+    glblasMemory_t buf[BUFFERS];
+
+    for (int b = 0; b < BUFFERS; b++) {
+        initial[b] = malloc(sizes[b] * sizeof(float));
+        expected[b] = malloc(sizes[b] * sizeof(float));
+        immediate[b] = malloc(sizes[b] * sizeof(float));
+        deferred[b] = malloc(sizes[b] * sizeof(float));
+        for (int i = 0; i < sizes[b]; i++)
+            initial[b][i] = expected[b][i] = ((i * 7 + b * 5) % 17 - 8) * .125f;
+        buf[b] = glblasMalloc(ctx, sizes[b] * sizeof(float));
+    }
+
+    run_host(expected);
+
+    for (int mode = 0; mode < 2; mode++) {
+        for (int b = 0; b < BUFFERS; b++)
+            glblasMemcpy(buf[b], initial[b], sizes[b] * sizeof(float), glblasMemcpyInfer);
+
+        assert(glblasSetExecutionMode(ctx, mode ? GLBLAS_EXECUTION_DEFERRED : GLBLAS_EXECUTION_IMMEDIATE) == GLBLAS_STATUS_SUCCESS);
+        run_device(buf);
+        assert(glblasFlush(ctx) == GLBLAS_STATUS_SUCCESS);
+        assert(glblasSetExecutionMode(ctx, GLBLAS_EXECUTION_IMMEDIATE) == GLBLAS_STATUS_SUCCESS);
+
+        for (int b = 0; b < BUFFERS; b++)
+            glblasMemcpy(mode ? deferred[b] : immediate[b], buf[b], sizes[b] * sizeof(float), glblasMemcpyInfer);
+    }
+
+    check("immediate against the host", expected, immediate);
+    check("deferred against the host", expected, deferred);
+    check("deferred against immediate", immediate, deferred);
+
+    // a recorded chain also runs when another call needs its result
+    glblasMemory_t dot = glblasMalloc(ctx, sizeof(float));
+    float expected_dot = 0.f, got_dot;
+    for (int i = 0; i < 1003; i++)
+        expected_dot += (2.f * initial[0][i] + initial[1][i]) * initial[1][i];
+
+    glblasMemcpy(buf[0], initial[0], 1003 * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(buf[1], initial[1], 1003 * sizeof(float), glblasMemcpyInfer);
+    glblasSetExecutionMode(ctx, GLBLAS_EXECUTION_DEFERRED);
+    glblasSscal(1003, 2.f, buf[0], 1);
+    glblasSaxpy(1003, 1.f, buf[1], 1, buf[0], 1);
+    glblasSdot(1003, dot, buf[0], 1, buf[1], 1);
+    glblasSetExecutionMode(ctx, GLBLAS_EXECUTION_IMMEDIATE);
+    glblasMemcpy(&got_dot, dot, sizeof(float), glblasMemcpyInfer);
+
+    float err = fabsf(got_dot - expected_dot) / (1.f + fabsf(expected_dot));
+    printf("%-32s error %g\n", "sdot after a recorded chain", err);
+    if (!(err <= 1e-5f))
+        failures++;
+
+    // automatically frees buffers, user may use `glblasFree` instead
+    glblasDestroy(ctx);
+
+    for (int b = 0; b < BUFFERS; b++) {
+        free(initial[b]);
+        free(expected[b]);
+        free(immediate[b]);
+        free(deferred[b]);
+    }
+
+    puts(failures ? "FAILED" : "OK");
+
+    return failures != 0;
+}
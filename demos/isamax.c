@@ -0,0 +1,75 @@
+#include "../glblas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+
+static int failures = 0;
+
+// 1-based index of the first largest (smallest) |x[e * incx]|, e * incx < n like the kernel's N
+static int iamax_host(int n, const float *x, int incx, int smallest)
+{
+    int best = 0;
+    float best_value = 0.f;
+    for (int e = 0; e * incx < n; e++) {
+        float v = fabsf(x[e * incx]);
+        if (best == 0 || (smallest ? v < best_value : v > best_value)) {
+            best = e + 1;
+            best_value = v;
+        }
+    }
+    return best;
+}
+
+static void run(glblasHandle_t ctx, int n, int incx)
+{
+    float *x = malloc(n * sizeof(float));
+    // plenty of ties, the first one has to win
+    for (int i = 0; i < n; i++)
+        x[i] = ((i * 7919) % 2001 - 1000) / 10.f;
+
+    glblasMemory_t dx = glblasMalloc(ctx, n * sizeof(float));
+    glblasMemory_t dr = glblasMalloc(ctx, 1 * sizeof(float));
+    glblasMemcpy(dx, x, n * sizeof(float), glblasMemcpyInfer);
+
+    for (int smallest = 0; smallest < 2; smallest++) {
+        float index;
+        if (smallest)
+            assert(glblasIsamin(n, dr, dx, incx) == GLBLAS_STATUS_SUCCESS);
+        else
+            assert(glblasIsamax(n, dr, dx, incx) == GLBLAS_STATUS_SUCCESS);
+        // in device pointer mode the index is written as a float
+        glblasMemcpy(&index, dr, 1 * sizeof(float), glblasMemcpyInfer);
+
+        int expected = iamax_host(n, x, incx, smallest);
+
+        printf("%s n = %d, incx = %d: %d (expected %d)\n", smallest ? "isamin" : "isamax", n, incx, (int)index, expected);
+        if ((int)index != expected)
+            failures++;
+    }
+
+    glblasFree(dx);
+    glblasFree(dr);
+    free(x);
+}
+
+int main()
+{
+    // device buffers are laid out in rows of 128 texels
+    glblasStatus_t status;
+    glblasHandle_t ctx;
+
+    assert((status = glblasCreate(&ctx, 128, 128)) == GLBLAS_STATUS_SUCCESS);
+
+    run(ctx, 1, 1);
+    run(ctx, 13, 1);
+    run(ctx, 100003, 1);
+    run(ctx, 100003, 5);
+
+    // automatically frees buffers, user may use `glblasFree` instead
+    glblasDestroy(ctx);
+
+    puts(failures ? "FAILED" : "OK");
+
+    return failures != 0;
+}
@@ -0,0 +1,93 @@
+#include "../glblas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#define N 1003
+
+static int failures = 0;
+
+static void check(const char *name, const float *expected, const float *got, int n)
+{
+    int mismatches = 0;
+    for (int i = 0; i < n; i++)
+        mismatches += expected[i] != got[i];
+
+    printf("%-44s %d mismatches\n", name, mismatches);
+    if (mismatches)
+        failures++;
+}
+
+int main()
+{
+    // device buffers are laid out in rows of 16 texels, so N floats span several rows and end mid texel
+    glblasStatus_t status;
+    glblasHandle_t ctx;
+
+    assert((status = glblasCreate(&ctx, 16, 16)) == GLBLAS_STATUS_SUCCESS);
+
+    float *old = malloc(N * sizeof(float));
+    float *new = malloc(N * sizeof(float));
+    float *expected = malloc(N * sizeof(float));
+    float *got = malloc(N * sizeof(float));
+
+    for (int i = 0; i < N; i++) {
+        old[i] = -(i + 1.f);
+        new[i] = i + 1.f;
+    }
+
+    glblasMemory_t dx = glblasMalloc(ctx, N * sizeof(float));
+
+    // partial uploads over data already on the device, ending mid texel and inside a single texel
+    const int sizes[] = { 6, 3, 517, N };
+    for (int s = 0; s < 4; s++) {
+        glblasMemcpy(dx, old, N * sizeof(float), glblasMemcpyInfer);
+        assert(glblasMemcpyAsync(dx, new, sizes[s] * sizeof(float), glblasMemcpyHostToDevice) == GLBLAS_STATUS_SUCCESS);
+        assert(glblasMemcpyWait(ctx) == GLBLAS_STATUS_SUCCESS);
+
+        for (int i = 0; i < N; i++)
+            expected[i] = i < sizes[s] ? new[i] : old[i];
+        glblasMemcpy(got, dx, N * sizeof(float), glblasMemcpyInfer);
+
+        char name[64];
+        snprintf(name, sizeof(name), "async upload of %d floats", sizes[s]);
+        check(name, expected, got, N);
+    }
+
+    // async download, valid once the copies have completed
+    for (int i = 0; i < N; i++)
+        got[i] = 0.f;
+    assert(glblasMemcpyAsync(got, dx, N * sizeof(float), glblasMemcpyDeviceToHost) == GLBLAS_STATUS_SUCCESS);
+    while ((status = glblasMemcpyQuery(ctx)) == GLBLAS_STATUS_NOT_READY)
+        ;
+    assert(status == GLBLAS_STATUS_SUCCESS);
+    check("async download", new, got, N);
+
+    // an event recorded after a kernel and a download covers both
+    glblasEvent_t event;
+    assert(glblasEventCreate(ctx, &event) == GLBLAS_STATUS_SUCCESS);
+
+    glblasSscal(N, 2.f, dx, 1);
+    assert(glblasMemcpyAsync(got, dx, N * sizeof(float), glblasMemcpyDeviceToHost) == GLBLAS_STATUS_SUCCESS);
+    assert(glblasEventRecord(event) == GLBLAS_STATUS_SUCCESS);
+    assert(glblasEventSynchronize(event) == GLBLAS_STATUS_SUCCESS);
+    assert(glblasEventQuery(event) == GLBLAS_STATUS_SUCCESS);
+
+    for (int i = 0; i < N; i++)
+        expected[i] = 2.f * new[i];
+    check("sscal and async download behind an event", expected, got, N);
+
+    glblasEventDestroy(event);
+
+    // automatically frees buffers, user may use `glblasFree` instead
+    glblasDestroy(ctx);
+
+    free(old);
+    free(new);
+    free(expected);
+    free(got);
+
+    puts(failures ? "FAILED" : "OK");
+
+    return failures != 0;
+}
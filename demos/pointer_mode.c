@@ -0,0 +1,178 @@
+#include "../glblas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+
+#define N 1003
+#define M 37
+#define K 29
+#define P 41
+
+static int failures = 0;
+
+static void check(const char *name, float expected, float got)
+{
+    float err = fabsf(expected - got) / (1.f + fabsf(expected));
+    printf("%-36s %f (expected %f)\n", name, got, expected);
+    if (!(err <= 1e-4f))
+        failures++;
+}
+
+static void check_matrix(const char *name, const float *expected, const float *got, int size)
+{
+    float err = 0.f;
+    for (int i = 0; i < size; i++)
+        err = fmaxf(err, fabsf(expected[i] - got[i]) / (1.f + fabsf(expected[i])));
+
+    printf("%-36s max error %g\n", name, err);
+    if (!(err <= 1e-4f))
+        failures++;
+}
+
+// c = alpha*a*b + beta*c, column-major with a M by K and b K by P
+static void sgemm_host(float alpha, const float *a, const float *b, float beta, float *c)
+{
+    for (int j = 0; j < P; j++)
+        for (int i = 0; i < M; i++) {
+            float sum = 0.f;
+            for (int k = 0; k < K; k++)
+                sum += a[k * M + i] * b[j * K + k];
+            c[j * M + i] = alpha * sum + beta * c[j * M + i];
+        }
+}
+
+int main()
+{
+    // device buffers are laid out in rows of 128 texels
+    glblasStatus_t status;
+    glblasHandle_t ctx;
+    glblasPointerMode_t mode;
+
+    assert((status = glblasCreate(&ctx, 128, 128)) == GLBLAS_STATUS_SUCCESS);
+    assert(glblasGetPointerMode(ctx, &mode) == GLBLAS_STATUS_SUCCESS && mode == GLBLAS_POINTER_MODE_DEVICE);
+
+    float *x = malloc(N * sizeof(float));
+    float *y = malloc(N * sizeof(float));
+    float *a = malloc(M * K * sizeof(float));
+    float *b = malloc(K * P * sizeof(float));
+    float *c = malloc(M * P * sizeof(float));
+    float *expected = malloc(M * P * sizeof(float));
+    float *got = malloc(M * P * sizeof(float));
+
+    for (int i = 0; i < N; i++) {
+        x[i] = ((i * 7) % 23 - 11) * .0625f;
+        y[i] = ((i * 5) % 13 - 6) * .125f;
+    }
+    x[613] = -2.f;
+
+    float dot = 0.f;
+    int amax = 0;
+    for (int i = 0; i < N; i++) {
+        dot += x[i] * y[i];
+        if (fabsf(x[i]) > fabsf(x[amax]))
+            amax = i;
+    }
+
+    for (int i = 0; i < M * K; i++)
+        a[i] = (i % 9 - 4) * .25f;
+    for (int i = 0; i < K * P; i++)
+        b[i] = (i % 7 - 3) * .5f;
+    for (int i = 0; i < M * P; i++)
+        c[i] = (i % 5 - 2) * 1.f;
+
+    glblasMemory_t dX = glblasMalloc(ctx, N * sizeof(float));
+    glblasMemory_t dY = glblasMalloc(ctx, N * sizeof(float));
+    glblasMemory_t dA = glblasMalloc(ctx, M * K * sizeof(float));
+    glblasMemory_t dB = glblasMalloc(ctx, K * P * sizeof(float));
+    glblasMemory_t dC = glblasMalloc(ctx, M * P * sizeof(float));
+    glblasMemory_t dResult = glblasMalloc(ctx, sizeof(float));
+    glblasMemory_t dAlpha = glblasMalloc(ctx, sizeof(float));
+    glblasMemory_t dBeta = glblasMalloc(ctx, sizeof(float));
+
+    glblasMemcpy(dX, x, N * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(dY, y, N * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(dA, a, M * K * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(dB, b, K * P * sizeof(float), glblasMemcpyInfer);
+
+    // device mode: results land in the first float of a buffer
+    float result;
+    glblasSdot(N, dResult, dX, 1, dY, 1);
+    glblasMemcpy(&result, dResult, sizeof(float), glblasMemcpyInfer);
+    check("sdot, device pointer mode", dot, result);
+
+    glblasIsamax(N, dResult, dX, 1);
+    glblasMemcpy(&result, dResult, sizeof(float), glblasMemcpyInfer);
+    check("isamax, device pointer mode", amax + 1, result);
+
+    // and alpha/beta of the _v2 kernels are read from buffers
+    float alpha = -1.5f, beta = .75f;
+    glblasMemcpy(dAlpha, &alpha, sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(dBeta, &beta, sizeof(float), glblasMemcpyInfer);
+
+    for (int i = 0; i < M * P; i++)
+        expected[i] = c[i];
+    sgemm_host(alpha, a, b, beta, expected);
+
+    glblasMemcpy(dC, c, M * P * sizeof(float), glblasMemcpyInfer);
+    assert(glblasSgemm_v2(GLBLAS_OP_N, GLBLAS_OP_N, M, P, K, dAlpha, dA, M, dB, K, dBeta, dC, M) == GLBLAS_STATUS_SUCCESS);
+    glblasMemcpy(got, dC, M * P * sizeof(float), glblasMemcpyInfer);
+    check_matrix("sgemm_v2, device pointer mode", expected, got, M * P);
+
+    // a device result feeds the next kernel without reading it back
+    glblasSdot(N, dAlpha, dX, 1, dY, 1);
+    assert(glblasSaxpy_v2(N, dAlpha, dX, 1, dY, 1) == GLBLAS_STATUS_SUCCESS);
+    glblasSdot(N, dResult, dX, 1, dY, 1);
+    glblasMemcpy(&result, dResult, sizeof(float), glblasMemcpyInfer);
+
+    float xx = 0.f;
+    for (int i = 0; i < N; i++)
+        xx += x[i] * x[i];
+    check("sdot after saxpy_v2 by a device sdot", dot + dot * xx, result);
+
+    // host mode: results and scalars are host pointers
+    assert(glblasSetPointerMode(ctx, GLBLAS_POINTER_MODE_HOST) == GLBLAS_STATUS_SUCCESS);
+    assert(glblasGetPointerMode(ctx, &mode) == GLBLAS_STATUS_SUCCESS && mode == GLBLAS_POINTER_MODE_HOST);
+
+    glblasMemcpy(dY, y, N * sizeof(float), glblasMemcpyInfer);
+
+    result = -1.f;
+    glblasSdot(N, (glblasMemory_t)&result, dX, 1, dY, 1);
+    check("sdot, host pointer mode", dot, result);
+
+    int index = -1;
+    glblasIsamax(N, (glblasMemory_t)&index, dX, 1);
+    check("isamax, host pointer mode", amax + 1, index);
+
+    alpha = .5f;
+    beta = -2.f;
+    for (int i = 0; i < M * P; i++)
+        expected[i] = c[i];
+    sgemm_host(alpha, a, b, beta, expected);
+
+    glblasMemcpy(dC, c, M * P * sizeof(float), glblasMemcpyInfer);
+    assert(glblasSgemm_v2(GLBLAS_OP_N, GLBLAS_OP_N, M, P, K, &alpha, dA, M, dB, K, &beta, dC, M) == GLBLAS_STATUS_SUCCESS);
+    glblasMemcpy(got, dC, M * P * sizeof(float), glblasMemcpyInfer);
+    check_matrix("sgemm_v2, host pointer mode", expected, got, M * P);
+
+    // the plain entry points take scalars by value in either mode
+    glblasMemcpy(dC, c, M * P * sizeof(float), glblasMemcpyInfer);
+    glblasSgemm(GLBLAS_OP_N, GLBLAS_OP_N, M, P, K, alpha, dA, M, dB, K, beta, dC, M);
+    glblasMemcpy(got, dC, M * P * sizeof(float), glblasMemcpyInfer);
+    check_matrix("sgemm, host pointer mode", expected, got, M * P);
+
+    // automatically frees buffers, user may use `glblasFree` instead
+    glblasDestroy(ctx);
+
+    free(x);
+    free(y);
+    free(a);
+    free(b);
+    free(c);
+    free(expected);
+    free(got);
+
+    puts(failures ? "FAILED" : "OK");
+
+    return failures != 0;
+}
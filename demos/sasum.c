@@ -7,7 +7,7 @@
 
 int main() 
 {
-    // create a pbuffer of size 512x512x4
+    // device buffers are laid out in rows of 512 texels
     glblasStatus_t status;
     glblasHandle_t ctx;
 
@@ -7,7 +7,7 @@
 
 int main() 
 {
-    // create a pbuffer of size 8192x8192x4
+    // device buffers are laid out in rows of 8192 texels
     glblasStatus_t status;
     glblasHandle_t ctx;
 
@@ -7,7 +7,7 @@
 
 int main() 
 {
-    // create a pbuffer of size 4096x4096x4
+    // device buffers are laid out in rows of 4096 texels
     glblasStatus_t status;
     glblasHandle_t ctx;
 
@@ -7,7 +7,7 @@
 
 int main() 
 {
-    // create a pbuffer of size 16x16x4
+    // device buffers are laid out in rows of 16 texels
     glblasStatus_t status;
     glblasHandle_t ctx;
 
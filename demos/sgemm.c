@@ -9,7 +9,7 @@
 
 int main() 
 {
-    // create a pbuffer of size 128x128x4
+    // device buffers are laid out in rows of 128 texels
     glblasStatus_t status;
     glblasHandle_t ctx;
 
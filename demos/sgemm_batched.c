@@ -0,0 +1,120 @@
+#include "../glblas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+
+static int failures = 0;
+
+// c = alpha*op(a)*op(b) + beta*c on the host
+static void sgemm_host(glblasOperation_t transa, glblasOperation_t transb, int m, int n, int k, float alpha, const float *a, int lda, const float *b, int ldb, float beta, float *c, int ldc)
+{
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < m; i++) {
+            double acc = 0.0;
+            for (int l = 0; l < k; l++)
+                acc += (double)(transa == GLBLAS_OP_N ? a[l * lda + i] : a[i * lda + l]) * (transb == GLBLAS_OP_N ? b[j * ldb + l] : b[l * ldb + j]);
+            c[j * ldc + i] = alpha * acc + beta * c[j * ldc + i];
+        }
+    }
+}
+
+// batch problems in separate buffers; with shared_a every problem names the same a
+static void run(glblasHandle_t ctx, glblasOperation_t transa, glblasOperation_t transb, int m, int n, int k, int lda, int ldb, int ldc, int batch, int shared_a, float alpha, float beta)
+{
+    int size_a = lda * (transa == GLBLAS_OP_N ? k : m);
+    int size_b = ldb * (transb == GLBLAS_OP_N ? n : k);
+    int size_c = ldc * n;
+
+    float *a = malloc(batch * size_a * sizeof(float));
+    float *b = malloc(batch * size_b * sizeof(float));
+    float *c = malloc(batch * size_c * sizeof(float));
+    float *got = malloc(batch * size_c * sizeof(float));
+    glblasMemory_t *da = malloc(batch * sizeof(glblasMemory_t));
+    glblasMemory_t *db = malloc(batch * sizeof(glblasMemory_t));
+    glblasMemory_t *dc = malloc(batch * sizeof(glblasMemory_t));
+
+    for (int i = 0; i < batch * size_a; i++)
+        a[i] = ((i * 7) % 13 - 6) * .25f;
+    for (int i = 0; i < batch * size_b; i++)
+        b[i] = ((i * 5) % 11 - 5) * .5f;
+    for (int i = 0; i < batch * size_c; i++)
+        c[i] = (i % 9) - 4.f;
+
+    for (int p = 0; p < batch; p++) {
+        da[p] = shared_a && p ? da[0] : glblasMalloc(ctx, size_a * sizeof(float));
+        db[p] = glblasMalloc(ctx, size_b * sizeof(float));
+        dc[p] = glblasMalloc(ctx, size_c * sizeof(float));
+        if (!shared_a || !p)
+            glblasMemcpy(da[p], a + p * size_a, size_a * sizeof(float), glblasMemcpyInfer);
+        glblasMemcpy(db[p], b + p * size_b, size_b * sizeof(float), glblasMemcpyInfer);
+        glblasMemcpy(dc[p], c + p * size_c, size_c * sizeof(float), glblasMemcpyInfer);
+    }
+
+    assert(glblasSgemmBatched(transa, transb, m, n, k, alpha, da, lda, db, ldb, beta, dc, ldc, batch) == GLBLAS_STATUS_SUCCESS);
+
+    for (int p = 0; p < batch; p++) {
+        glblasMemcpy(got + p * size_c, dc[p], size_c * sizeof(float), glblasMemcpyInfer);
+        // padding rows stay as they were
+        sgemm_host(transa, transb, m, n, k, alpha, a + (shared_a ? 0 : p * size_a), lda, b + p * size_b, ldb, beta, c + p * size_c, ldc);
+    }
+
+    float err = 0.f;
+    for (int i = 0; i < batch * size_c; i++)
+        err = fmaxf(err, fabsf(c[i] - got[i]) / (1.f + fabsf(c[i])));
+
+    printf("sgemm batched %c%c m = %d, n = %d, k = %d, ld = %d/%d/%d, batch = %d%s: max error %g\n",
+           transa == GLBLAS_OP_N ? 'N' : 'T', transb == GLBLAS_OP_N ? 'N' : 'T', m, n, k, lda, ldb, ldc, batch, shared_a ? ", shared a" : "", err);
+    if (!(err <= 1e-4f))
+        failures++;
+
+    for (int p = 0; p < batch; p++) {
+        if (!shared_a || !p)
+            glblasFree(da[p]);
+        glblasFree(db[p]);
+        glblasFree(dc[p]);
+    }
+    free(da);
+    free(db);
+    free(dc);
+    free(a);
+    free(b);
+    free(c);
+    free(got);
+}
+
+int main()
+{
+    // device buffers are laid out in rows of 128 texels
+    glblasStatus_t status;
+    glblasHandle_t ctx;
+
+    assert((status = glblasCreate(&ctx, 128, 128)) == GLBLAS_STATUS_SUCCESS);
+
+    for (int transa = 0; transa < 2; transa++) {
+        for (int transb = 0; transb < 2; transb++) {
+            int lda = transa ? 13 : 17, ldb = transb ? 9 : 13;
+            run(ctx, transa, transb, 17, 9, 13, lda, ldb, 17, 5, 0, 1.f, 0.f);
+            run(ctx, transa, transb, 17, 9, 13, lda + 3, ldb + 1, 19, 4, 1, .5f, -1.f);
+            run(ctx, transa, transb, 68, 36, 20, 68, 36, 68, 3, 0, 2.f, 1.f);
+        }
+    }
+    run(ctx, GLBLAS_OP_N, GLBLAS_OP_N, 3, 5, 7, 3, 7, 3, 1, 0, 1.f, 0.f);
+
+    // an empty batch is a no-op for both entry points, even without arrays
+    const float one = 1.f, zero = 0.f;
+    glblasSetPointerMode(ctx, GLBLAS_POINTER_MODE_HOST);
+    status = glblasSgemmBatched(GLBLAS_OP_N, GLBLAS_OP_N, 4, 4, 4, one, NULL, 4, NULL, 4, zero, NULL, 4, 0);
+    printf("sgemm batched, batch = 0: status %d\n", status);
+    failures += status != GLBLAS_STATUS_SUCCESS;
+    status = glblasSgemmBatched_v2(GLBLAS_OP_N, GLBLAS_OP_N, 4, 4, 4, &one, NULL, 4, NULL, 4, &zero, NULL, 4, 0);
+    printf("sgemm batched _v2, batch = 0: status %d\n", status);
+    failures += status != GLBLAS_STATUS_SUCCESS;
+
+    // automatically frees buffers, user may use `glblasFree` instead
+    glblasDestroy(ctx);
+
+    puts(failures ? "FAILED" : "OK");
+
+    return failures != 0;
+}
@@ -0,0 +1,103 @@
+#include "../glblas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+
+static int failures = 0;
+
+// c = alpha*op(a)*op(b) + beta*c on the host
+static void sgemm_host(glblasOperation_t transa, glblasOperation_t transb, int m, int n, int k, float alpha, const float *a, int lda, const float *b, int ldb, float beta, float *c, int ldc)
+{
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < m; i++) {
+            double acc = 0.0;
+            for (int l = 0; l < k; l++)
+                acc += (double)(transa == GLBLAS_OP_N ? a[l * lda + i] : a[i * lda + l]) * (transb == GLBLAS_OP_N ? b[j * ldb + l] : b[l * ldb + j]);
+            c[j * ldc + i] = alpha * acc + beta * c[j * ldc + i];
+        }
+    }
+}
+
+// batch problems stride_a/b/c floats apart in one buffer each; a stride of 0 shares the operand
+static void run(glblasHandle_t ctx, glblasOperation_t transa, glblasOperation_t transb, int m, int n, int k, int lda, int ldb, int ldc,
+                int stride_a, int stride_b, int stride_c, int batch, float alpha, float beta)
+{
+    int size_a = (batch - 1) * stride_a + lda * (transa == GLBLAS_OP_N ? k : m);
+    int size_b = (batch - 1) * stride_b + ldb * (transb == GLBLAS_OP_N ? n : k);
+    int size_c = (batch - 1) * stride_c + ldc * n;
+
+    float *a = malloc(size_a * sizeof(float));
+    float *b = malloc(size_b * sizeof(float));
+    float *c = malloc(size_c * sizeof(float));
+    float *got = malloc(size_c * sizeof(float));
+
+    for (int i = 0; i < size_a; i++)
+        a[i] = ((i * 7) % 13 - 6) * .25f;
+    for (int i = 0; i < size_b; i++)
+        b[i] = ((i * 5) % 11 - 5) * .5f;
+    for (int i = 0; i < size_c; i++)
+        c[i] = (i % 9) - 4.f;
+
+    glblasMemory_t da = glblasMalloc(ctx, size_a * sizeof(float));
+    glblasMemory_t db = glblasMalloc(ctx, size_b * sizeof(float));
+    glblasMemory_t dc = glblasMalloc(ctx, size_c * sizeof(float));
+    glblasMemcpy(da, a, size_a * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(db, b, size_b * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(dc, c, size_c * sizeof(float), glblasMemcpyInfer);
+
+    assert(glblasSgemmStridedBatched(transa, transb, m, n, k, alpha, da, lda, stride_a, db, ldb, stride_b, beta, dc, ldc, stride_c, batch) == GLBLAS_STATUS_SUCCESS);
+    glblasMemcpy(got, dc, size_c * sizeof(float), glblasMemcpyInfer);
+
+    // padding rows and the gaps between problems stay as they were
+    for (int p = 0; p < batch; p++)
+        sgemm_host(transa, transb, m, n, k, alpha, a + p * stride_a, lda, b + p * stride_b, ldb, beta, c + p * stride_c, ldc);
+
+    float err = 0.f;
+    for (int i = 0; i < size_c; i++)
+        err = fmaxf(err, fabsf(c[i] - got[i]) / (1.f + fabsf(c[i])));
+
+    printf("sgemm strided batched %c%c m = %d, n = %d, k = %d, ld = %d/%d/%d, strides = %d/%d/%d, batch = %d: max error %g\n",
+           transa == GLBLAS_OP_N ? 'N' : 'T', transb == GLBLAS_OP_N ? 'N' : 'T', m, n, k, lda, ldb, ldc, stride_a, stride_b, stride_c, batch, err);
+    if (!(err <= 1e-4f))
+        failures++;
+
+    glblasFree(da);
+    glblasFree(db);
+    glblasFree(dc);
+    free(a);
+    free(b);
+    free(c);
+    free(got);
+}
+
+int main()
+{
+    // device buffers are laid out in rows of 128 texels
+    glblasStatus_t status;
+    glblasHandle_t ctx;
+
+    assert((status = glblasCreate(&ctx, 128, 128)) == GLBLAS_STATUS_SUCCESS);
+
+    for (int transa = 0; transa < 2; transa++) {
+        for (int transb = 0; transb < 2; transb++) {
+            int lda = transa ? 13 : 17, ldb = transb ? 9 : 13;
+            int cols_a = transa ? 17 : 13, cols_b = transb ? 13 : 9;
+            // odd sizes packed back to back
+            run(ctx, transa, transb, 17, 9, 13, lda, ldb, 17, lda * cols_a, ldb * cols_b, 17 * 9, 5, 1.f, 0.f);
+            // padded leading dimensions, gaps between problems and a shared a
+            run(ctx, transa, transb, 17, 9, 13, lda + 3, ldb + 1, 19, 0, (ldb + 1) * cols_b + 2, 19 * 9 + 5, 4, .5f, -1.f);
+            // texel aligned problems, the blocked path
+            run(ctx, transa, transb, 68, 36, 20, 68, 36, 68, 68 * 36, 36 * 36, 68 * 36, 3, 2.f, 1.f);
+        }
+    }
+    // many small problems
+    run(ctx, GLBLAS_OP_N, GLBLAS_OP_N, 4, 4, 4, 4, 4, 4, 16, 16, 16, 1000, 1.f, 0.f);
+
+    // automatically frees buffers, user may use `glblasFree` instead
+    glblasDestroy(ctx);
+
+    puts(failures ? "FAILED" : "OK");
+
+    return failures != 0;
+}
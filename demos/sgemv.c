@@ -0,0 +1,85 @@
+#include "../glblas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+
+static int failures = 0;
+
+// y = alpha*op(a)*x + beta*y with a m by n, for both transpose modes
+static void run(glblasHandle_t ctx, glblasOperation_t trans, int m, int n, int lda, int incx, int incy, float alpha, float beta)
+{
+    int rows = trans == GLBLAS_OP_N ? m : n;
+    int inner = trans == GLBLAS_OP_N ? n : m;
+    int size_a = lda * n, size_x = (inner - 1) * incx + 1, size_y = (rows - 1) * incy + 1;
+
+    float *a = malloc(size_a * sizeof(float));
+    float *x = malloc(size_x * sizeof(float));
+    float *y = malloc(size_y * sizeof(float));
+    float *got = malloc(size_y * sizeof(float));
+
+    for (int i = 0; i < size_a; i++)
+        a[i] = ((i * 37) % 19 - 9) * .125f;
+    for (int i = 0; i < size_x; i++)
+        x[i] = ((i * 11) % 7 - 3) * .5f;
+    for (int i = 0; i < size_y; i++)
+        y[i] = (i % 5) - 2.f;
+
+    glblasMemory_t da = glblasMalloc(ctx, size_a * sizeof(float));
+    glblasMemory_t dx = glblasMalloc(ctx, size_x * sizeof(float));
+    glblasMemory_t dy = glblasMalloc(ctx, size_y * sizeof(float));
+    glblasMemcpy(da, a, size_a * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(dx, x, size_x * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(dy, y, size_y * sizeof(float), glblasMemcpyInfer);
+
+    assert(glblasSgemv(trans, m, n, alpha, da, lda, dx, incx, beta, dy, incy) == GLBLAS_STATUS_SUCCESS);
+    glblasMemcpy(got, dy, size_y * sizeof(float), glblasMemcpyInfer);
+
+    // elements of y between the strided ones stay as they were
+    for (int r = 0; r < rows; r++) {
+        double acc = 0.0;
+        for (int l = 0; l < inner; l++)
+            acc += (double)(trans == GLBLAS_OP_N ? a[l * lda + r] : a[r * lda + l]) * x[l * incx];
+        y[r * incy] = alpha * acc + beta * y[r * incy];
+    }
+
+    float err = 0.f;
+    for (int i = 0; i < size_y; i++)
+        err = fmaxf(err, fabsf(y[i] - got[i]) / (1.f + fabsf(y[i])));
+
+    printf("sgemv %c m = %d, n = %d, lda = %d, incx = %d, incy = %d: max error %g\n", trans == GLBLAS_OP_N ? 'N' : 'T', m, n, lda, incx, incy, err);
+    if (!(err <= 1e-4f))
+        failures++;
+
+    glblasFree(da);
+    glblasFree(dx);
+    glblasFree(dy);
+    free(a);
+    free(x);
+    free(y);
+    free(got);
+}
+
+int main()
+{
+    // device buffers are laid out in rows of 128 texels
+    glblasStatus_t status;
+    glblasHandle_t ctx;
+
+    assert((status = glblasCreate(&ctx, 128, 128)) == GLBLAS_STATUS_SUCCESS);
+
+    for (int trans = 0; trans < 2; trans++) {
+        run(ctx, trans, 37, 53, 37, 1, 1, 1.f, 0.f);
+        run(ctx, trans, 37, 53, 40, 2, 3, .5f, -1.f);
+        // long enough inner dimension for the split reduction
+        run(ctx, trans, 5, 3001, 7, 1, 1, 2.f, 1.f);
+        run(ctx, trans, 3001, 5, 3001, 3, 1, 2.f, 1.f);
+    }
+
+    // automatically frees buffers, user may use `glblasFree` instead
+    glblasDestroy(ctx);
+
+    puts(failures ? "FAILED" : "OK");
+
+    return failures != 0;
+}
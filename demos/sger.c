@@ -0,0 +1,77 @@
+#include "../glblas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+
+static int failures = 0;
+
+// a = alpha*x*y^T + a with a m by n
+static void run(glblasHandle_t ctx, int m, int n, int lda, int incx, int incy, float alpha)
+{
+    int size_a = lda * n, size_x = (m - 1) * incx + 1, size_y = (n - 1) * incy + 1;
+
+    float *a = malloc(size_a * sizeof(float));
+    float *x = malloc(size_x * sizeof(float));
+    float *y = malloc(size_y * sizeof(float));
+    float *got = malloc(size_a * sizeof(float));
+
+    for (int i = 0; i < size_a; i++)
+        a[i] = (i % 9) - 4.f;
+    for (int i = 0; i < size_x; i++)
+        x[i] = ((i * 11) % 7 - 3) * .5f;
+    for (int i = 0; i < size_y; i++)
+        y[i] = ((i * 5) % 11 - 5) * .25f;
+
+    glblasMemory_t da = glblasMalloc(ctx, size_a * sizeof(float));
+    glblasMemory_t dx = glblasMalloc(ctx, size_x * sizeof(float));
+    glblasMemory_t dy = glblasMalloc(ctx, size_y * sizeof(float));
+    glblasMemcpy(da, a, size_a * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(dx, x, size_x * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(dy, y, size_y * sizeof(float), glblasMemcpyInfer);
+
+    assert(glblasSger(m, n, alpha, dx, incx, dy, incy, da, lda) == GLBLAS_STATUS_SUCCESS);
+    glblasMemcpy(got, da, size_a * sizeof(float), glblasMemcpyInfer);
+
+    // rows past m are padding and stay as they were
+    for (int j = 0; j < n; j++)
+        for (int i = 0; i < m; i++)
+            a[j * lda + i] += alpha * x[i * incx] * y[j * incy];
+
+    float err = 0.f;
+    for (int i = 0; i < size_a; i++)
+        err = fmaxf(err, fabsf(a[i] - got[i]) / (1.f + fabsf(a[i])));
+
+    printf("sger m = %d, n = %d, lda = %d, incx = %d, incy = %d: max error %g\n", m, n, lda, incx, incy, err);
+    if (!(err <= 1e-5f))
+        failures++;
+
+    glblasFree(da);
+    glblasFree(dx);
+    glblasFree(dy);
+    free(a);
+    free(x);
+    free(y);
+    free(got);
+}
+
+int main()
+{
+    // device buffers are laid out in rows of 128 texels
+    glblasStatus_t status;
+    glblasHandle_t ctx;
+
+    assert((status = glblasCreate(&ctx, 128, 128)) == GLBLAS_STATUS_SUCCESS);
+
+    run(ctx, 1, 1, 1, 1, 1, 1.f);
+    run(ctx, 37, 53, 37, 1, 1, 1.f);
+    run(ctx, 37, 53, 41, 2, 3, -.5f);
+    run(ctx, 64, 9, 64, 1, 2, 2.f);
+
+    // automatically frees buffers, user may use `glblasFree` instead
+    glblasDestroy(ctx);
+
+    puts(failures ? "FAILED" : "OK");
+
+    return failures != 0;
+}
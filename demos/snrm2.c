@@ -0,0 +1,74 @@
+#include "../glblas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+
+static int failures = 0;
+
+// norm of the elements e * incx < n, like the kernel's N
+static double nrm2_host(int n, const float *x, int incx)
+{
+    double scale = 0.0, sum = 1.0;
+    for (int e = 0; e * incx < n; e++) {
+        double v = fabs(x[e * incx]);
+        if (v == 0.0)
+            continue;
+        if (v > scale) {
+            sum = 1.0 + sum * (scale / v) * (scale / v);
+            scale = v;
+        }
+        else
+            sum += (v / scale) * (v / scale);
+    }
+    return scale * sqrt(sum);
+}
+
+static void run(glblasHandle_t ctx, int n, int incx, float magnitude)
+{
+    float *x = malloc(n * sizeof(float));
+    for (int i = 0; i < n; i++)
+        x[i] = ((i * 37) % 201 - 100) / 100.f * magnitude;
+
+    glblasMemory_t dx = glblasMalloc(ctx, n * sizeof(float));
+    glblasMemory_t dr = glblasMalloc(ctx, 1 * sizeof(float));
+    glblasMemcpy(dx, x, n * sizeof(float), glblasMemcpyInfer);
+
+    float got;
+    assert(glblasSnrm2(n, dr, dx, incx) == GLBLAS_STATUS_SUCCESS);
+    glblasMemcpy(&got, dr, 1 * sizeof(float), glblasMemcpyInfer);
+
+    double expected = nrm2_host(n, x, incx);
+    double err = fabs(got - expected) / expected;
+
+    printf("snrm2 n = %d, incx = %d, |x| ~ %g: %g (expected %g, error %g)\n", n, incx, magnitude, got, expected, err);
+    if (!(err <= 1e-5))
+        failures++;
+
+    glblasFree(dx);
+    glblasFree(dr);
+    free(x);
+}
+
+int main()
+{
+    // device buffers are laid out in rows of 128 texels
+    glblasStatus_t status;
+    glblasHandle_t ctx;
+
+    assert((status = glblasCreate(&ctx, 128, 128)) == GLBLAS_STATUS_SUCCESS);
+
+    run(ctx, 7, 1, 1.f);
+    run(ctx, 10001, 1, 1.f);
+    run(ctx, 10001, 3, 1.f);
+    // squares of these over- and underflow a float sum
+    run(ctx, 4099, 1, 1e30f);
+    run(ctx, 4099, 2, 1e-30f);
+
+    // automatically frees buffers, user may use `glblasFree` instead
+    glblasDestroy(ctx);
+
+    puts(failures ? "FAILED" : "OK");
+
+    return failures != 0;
+}
@@ -0,0 +1,152 @@
+#include "../glblas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+
+#define N 1001
+
+static int failures = 0;
+
+static void check(const char *name, const float *expected, const float *got, int n)
+{
+    float err = 0.f;
+    for (int i = 0; i < n; i++)
+        err = fmaxf(err, fabsf(expected[i] - got[i]) / (1.f + fabsf(expected[i])));
+
+    printf("%-28s max error %g\n", name, err);
+    if (!(err <= 1e-5f))
+        failures++;
+}
+
+// x' = h11*x + h12*y, y' = h21*x + h22*y on the host, n spans y like the kernels' N; x is written last, as in reference blas
+static void rot_host(int n, float *x, int incx, float *y, int incy, const float h[4])
+{
+    for (int i = 0; i * incy < n; i++) {
+        float xi = x[i * incx], yi = y[i * incy];
+        y[i * incy] = h[1] * xi + h[3] * yi;
+        x[i * incx] = h[0] * xi + h[2] * yi;
+    }
+}
+
+// rotate n elements of x and y at the given strides on the device and the host
+static void run(glblasHandle_t ctx, const char *name, int n, int incx, int incy, const float *param)
+{
+    int size_x = (n - 1) / incy * incx + 1, size_y = n;
+    float *x = malloc(size_x * sizeof(float)), *y = malloc(size_y * sizeof(float));
+    float *dx_out = malloc(size_x * sizeof(float)), *dy_out = malloc(size_y * sizeof(float));
+
+    for (int i = 0; i < size_x; i++)
+        x[i] = (i % 7) - 3.f;
+    for (int i = 0; i < size_y; i++)
+        y[i] = (i % 5) * .5f;
+
+    glblasMemory_t dx = glblasMalloc(ctx, size_x * sizeof(float));
+    glblasMemory_t dy = glblasMalloc(ctx, size_y * sizeof(float));
+    glblasMemcpy(dx, x, size_x * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(dy, y, size_y * sizeof(float), glblasMemcpyInfer);
+
+    float h[4];
+    if (param) {
+        assert(glblasSrotm(n, dx, incx, dy, incy, param) == GLBLAS_STATUS_SUCCESS);
+        // flag -1 only, the demo doesn't exercise the implied entries
+        h[0] = param[1]; h[1] = param[2]; h[2] = param[3]; h[3] = param[4];
+    }
+    else {
+        const float c = .6f, s = .8f;
+        assert(glblasSrot(n, dx, incx, dy, incy, c, s) == GLBLAS_STATUS_SUCCESS);
+        h[0] = c; h[1] = -s; h[2] = s; h[3] = c;
+    }
+    rot_host(n, x, incx, y, incy, h);
+
+    glblasMemcpy(dx_out, dx, size_x * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(dy_out, dy, size_y * sizeof(float), glblasMemcpyInfer);
+
+    printf("%s, n = %d, incx = %d, incy = %d\n", name, n, incx, incy);
+    check("  x", x, dx_out, size_x);
+    check("  y", y, dy_out, size_y);
+
+    glblasFree(dx);
+    glblasFree(dy);
+    free(x);
+    free(y);
+    free(dx_out);
+    free(dy_out);
+}
+
+// srot after a recorded sscal, with x and y of different lengths so the rotation can't run as one pass
+static void deferred(glblasHandle_t ctx)
+{
+    float x[100], y[400], expected_x[100], expected_y[400], got_x[100], got_y[400];
+    const float h[4] = { .6f, -.8f, .8f, .6f };
+
+    for (int i = 0; i < 100; i++)
+        x[i] = expected_x[i] = i * .01f - .5f;
+    for (int i = 0; i < 400; i++)
+        y[i] = expected_y[i] = (i % 3) - 1.f;
+
+    for (int i = 0; i < 100; i++)
+        expected_x[i] *= 3.f;
+    rot_host(100, expected_x, 1, expected_y, 1, h);
+
+    glblasMemory_t dx = glblasMalloc(ctx, sizeof(x));
+    glblasMemory_t dy = glblasMalloc(ctx, sizeof(y));
+    glblasMemcpy(dx, x, sizeof(x), glblasMemcpyInfer);
+    glblasMemcpy(dy, y, sizeof(y), glblasMemcpyInfer);
+
+    glblasSetExecutionMode(ctx, GLBLAS_EXECUTION_DEFERRED);
+    glblasSscal(100, 3.f, dx, 1);
+    glblasSrot(100, dx, 1, dy, 1, .6f, .8f);
+    glblasSetExecutionMode(ctx, GLBLAS_EXECUTION_IMMEDIATE);
+
+    glblasMemcpy(got_x, dx, sizeof(x), glblasMemcpyInfer);
+    glblasMemcpy(got_y, dy, sizeof(y), glblasMemcpyInfer);
+
+    printf("srot deferred, n = 100, x and y of different lengths\n");
+    check("  x", expected_x, got_x, 100);
+    check("  y", expected_y, got_y, 400);
+
+    // x == y in both modes, every element becomes (c + s) * x
+    for (int i = 0; i < 100; i++)
+        expected_x[i] = 3.f * x[i];
+    rot_host(100, expected_x, 1, expected_x, 1, h);
+
+    for (int mode = 0; mode < 2; mode++) {
+        glblasMemcpy(dx, x, sizeof(x), glblasMemcpyInfer);
+        glblasSetExecutionMode(ctx, mode ? GLBLAS_EXECUTION_DEFERRED : GLBLAS_EXECUTION_IMMEDIATE);
+        glblasSscal(100, 3.f, dx, 1);
+        glblasSrot(100, dx, 1, dx, 1, .6f, .8f);
+        glblasSetExecutionMode(ctx, GLBLAS_EXECUTION_IMMEDIATE);
+        glblasMemcpy(got_x, dx, sizeof(x), glblasMemcpyInfer);
+
+        printf("srot %s, x aliasing y\n", mode ? "deferred" : "immediate");
+        check("  x", expected_x, got_x, 100);
+    }
+
+    glblasFree(dx);
+    glblasFree(dy);
+}
+
+int main()
+{
+    // device buffers are laid out in rows of 128 texels
+    glblasStatus_t status;
+    glblasHandle_t ctx;
+
+    assert((status = glblasCreate(&ctx, 128, 128)) == GLBLAS_STATUS_SUCCESS);
+
+    const float param[5] = { -1.f, .5f, -2.f, 1.5f, .25f };
+
+    run(ctx, "srot", N, 1, 1, NULL);
+    run(ctx, "srot", N, 3, 2, NULL);
+    run(ctx, "srotm", N, 1, 1, param);
+    run(ctx, "srotm", 7, 2, 5, param);
+    deferred(ctx);
+
+    // automatically frees buffers, user may use `glblasFree` instead
+    glblasDestroy(ctx);
+
+    puts(failures ? "FAILED" : "OK");
+
+    return failures != 0;
+}
@@ -0,0 +1,80 @@
+#include "../glblas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+
+static int failures = 0;
+
+// c = alpha*op(a)*op(a)^T + beta*c on the uplo triangle of the n by n c, op(a) n by k
+static void run(glblasHandle_t ctx, glblasFillMode_t uplo, glblasOperation_t trans, int n, int k, int lda, int ldc, float alpha, float beta)
+{
+    int size_a = lda * (trans == GLBLAS_OP_N ? k : n), size_c = ldc * n;
+
+    float *a = malloc(size_a * sizeof(float));
+    float *c = malloc(size_c * sizeof(float));
+    float *got = malloc(size_c * sizeof(float));
+
+    for (int i = 0; i < size_a; i++)
+        a[i] = ((i * 7) % 13 - 6) * .25f;
+    for (int i = 0; i < size_c; i++)
+        c[i] = (i % 9) - 4.f;
+
+    glblasMemory_t da = glblasMalloc(ctx, size_a * sizeof(float));
+    glblasMemory_t dc = glblasMalloc(ctx, size_c * sizeof(float));
+    glblasMemcpy(da, a, size_a * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(dc, c, size_c * sizeof(float), glblasMemcpyInfer);
+
+    assert(glblasSsyrk(uplo, trans, n, k, alpha, da, lda, beta, dc, ldc) == GLBLAS_STATUS_SUCCESS);
+    glblasMemcpy(got, dc, size_c * sizeof(float), glblasMemcpyInfer);
+
+    // the other triangle and the padding rows stay as they were
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            if (uplo == GLBLAS_FILL_MODE_LOWER ? i < j : i > j)
+                continue;
+            double acc = 0.0;
+            for (int l = 0; l < k; l++)
+                acc += trans == GLBLAS_OP_N ? (double)a[l * lda + i] * a[l * lda + j] : (double)a[i * lda + l] * a[j * lda + l];
+            c[j * ldc + i] = alpha * acc + beta * c[j * ldc + i];
+        }
+    }
+
+    float err = 0.f;
+    for (int i = 0; i < size_c; i++)
+        err = fmaxf(err, fabsf(c[i] - got[i]) / (1.f + fabsf(c[i])));
+
+    printf("ssyrk %s %c n = %d, k = %d, lda = %d, ldc = %d: max error %g\n", uplo == GLBLAS_FILL_MODE_LOWER ? "lower" : "upper", trans == GLBLAS_OP_N ? 'N' : 'T', n, k, lda, ldc, err);
+    if (!(err <= 1e-4f))
+        failures++;
+
+    glblasFree(da);
+    glblasFree(dc);
+    free(a);
+    free(c);
+    free(got);
+}
+
+int main()
+{
+    // device buffers are laid out in rows of 128 texels
+    glblasStatus_t status;
+    glblasHandle_t ctx;
+
+    assert((status = glblasCreate(&ctx, 128, 128)) == GLBLAS_STATUS_SUCCESS);
+
+    for (int uplo = 0; uplo < 2; uplo++) {
+        for (int trans = 0; trans < 2; trans++) {
+            run(ctx, uplo, trans, 37, 21, trans ? 21 : 37, 37, 1.f, 0.f);
+            run(ctx, uplo, trans, 37, 21, trans ? 23 : 39, 40, .5f, -1.f);
+            run(ctx, uplo, trans, 130, 67, trans ? 68 : 132, 132, 2.f, 1.f);
+        }
+    }
+
+    // automatically frees buffers, user may use `glblasFree` instead
+    glblasDestroy(ctx);
+
+    puts(failures ? "FAILED" : "OK");
+
+    return failures != 0;
+}
@@ -0,0 +1,101 @@
+#include "../glblas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+
+static int failures = 0;
+
+// element (i, j) of op(a), a triangular in uplo with an implicit unit diagonal for GLBLAS_DIAG_UNIT
+static float op_tri(const float *a, int lda, glblasFillMode_t uplo, glblasOperation_t trans, glblasDiagType_t diag, int i, int j)
+{
+    if (trans != GLBLAS_OP_N) {
+        int t = i;
+        i = j;
+        j = t;
+    }
+    if (i == j)
+        return diag == GLBLAS_DIAG_UNIT ? 1.f : a[j * lda + i];
+    return (uplo == GLBLAS_FILL_MODE_LOWER ? i > j : i < j) ? a[j * lda + i] : 0.f;
+}
+
+// solve op(a)*x = alpha*b (left) or x*op(a) = alpha*b (right) in place of the m by n b, then check the residual on the host
+static void run(glblasHandle_t ctx, glblasSideMode_t side, glblasFillMode_t uplo, glblasOperation_t trans, glblasDiagType_t diag, int m, int n, int lda, int ldb, float alpha)
+{
+    int order = side == GLBLAS_SIDE_LEFT ? m : n;
+    int size_a = lda * order, size_b = ldb * n;
+
+    float *a = malloc(size_a * sizeof(float));
+    float *b = malloc(size_b * sizeof(float));
+    float *x = malloc(size_b * sizeof(float));
+
+    // small off diagonal entries keep op(a) well conditioned; with a unit diagonal the stored one must be ignored
+    for (int j = 0; j < order; j++)
+        for (int i = 0; i < lda; i++)
+            a[j * lda + i] = i == j ? (diag == GLBLAS_DIAG_UNIT ? 1000.f : 1.f + (i % 3) * .5f) : ((i * 7 + j * 3) % 13 - 6) * (.5f / order);
+    for (int i = 0; i < size_b; i++)
+        b[i] = (i % 7) - 3.f;
+
+    glblasMemory_t da = glblasMalloc(ctx, size_a * sizeof(float));
+    glblasMemory_t db = glblasMalloc(ctx, size_b * sizeof(float));
+    glblasMemcpy(da, a, size_a * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(db, b, size_b * sizeof(float), glblasMemcpyInfer);
+
+    assert(glblasStrsm(side, uplo, trans, diag, m, n, alpha, da, lda, db, ldb) == GLBLAS_STATUS_SUCCESS);
+    glblasMemcpy(x, db, size_b * sizeof(float), glblasMemcpyInfer);
+
+    float err = 0.f;
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < m; i++) {
+            double acc = 0.0;
+            for (int l = 0; l < order; l++)
+                acc += side == GLBLAS_SIDE_LEFT ? (double)op_tri(a, lda, uplo, trans, diag, i, l) * x[j * ldb + l]
+                                                : (double)x[l * ldb + i] * op_tri(a, lda, uplo, trans, diag, l, j);
+            float expected = alpha * b[j * ldb + i];
+            err = fmaxf(err, fabsf((float)acc - expected) / (1.f + fabsf(expected)));
+        }
+        // padding rows stay as they were
+        for (int i = m; i < ldb; i++)
+            if (x[j * ldb + i] != b[j * ldb + i])
+                err = fmaxf(err, 1.f);
+    }
+
+    printf("strsm %s %s %c %s m = %d, n = %d, lda = %d, ldb = %d: max residual %g\n", side == GLBLAS_SIDE_LEFT ? "left" : "right", uplo == GLBLAS_FILL_MODE_LOWER ? "lower" : "upper",
+           trans == GLBLAS_OP_N ? 'N' : 'T', diag == GLBLAS_DIAG_UNIT ? "unit" : "non-unit", m, n, lda, ldb, err);
+    if (!(err <= 1e-4f))
+        failures++;
+
+    glblasFree(da);
+    glblasFree(db);
+    free(a);
+    free(b);
+    free(x);
+}
+
+int main()
+{
+    // device buffers are laid out in rows of 128 texels
+    glblasStatus_t status;
+    glblasHandle_t ctx;
+
+    assert((status = glblasCreate(&ctx, 128, 128)) == GLBLAS_STATUS_SUCCESS);
+
+    for (int side = 0; side < 2; side++) {
+        for (int uplo = 0; uplo < 2; uplo++) {
+            for (int trans = 0; trans < 2; trans++) {
+                for (int diag = 0; diag < 2; diag++) {
+                    run(ctx, side, uplo, trans, diag, 7, 5, side ? 5 : 7, 7, 1.f);
+                    // more than one diagonal block of a
+                    run(ctx, side, uplo, trans, diag, side ? 45 : 133, side ? 133 : 45, 135, side ? 47 : 137, -2.f);
+                }
+            }
+        }
+    }
+
+    // automatically frees buffers, user may use `glblasFree` instead
+    glblasDestroy(ctx);
+
+    puts(failures ? "FAILED" : "OK");
+
+    return failures != 0;
+}
@@ -0,0 +1,93 @@
+#include "../glblas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+
+static int failures = 0;
+
+// element (i, j) of op(a), a triangular in uplo with an implicit unit diagonal for GLBLAS_DIAG_UNIT
+static float op_tri(const float *a, int lda, glblasFillMode_t uplo, glblasOperation_t trans, glblasDiagType_t diag, int i, int j)
+{
+    if (trans != GLBLAS_OP_N) {
+        int t = i;
+        i = j;
+        j = t;
+    }
+    if (i == j)
+        return diag == GLBLAS_DIAG_UNIT ? 1.f : a[j * lda + i];
+    return (uplo == GLBLAS_FILL_MODE_LOWER ? i > j : i < j) ? a[j * lda + i] : 0.f;
+}
+
+// solve op(a)*x = b in place of x, then check op(a)*x against b on the host
+static void run(glblasHandle_t ctx, glblasFillMode_t uplo, glblasOperation_t trans, glblasDiagType_t diag, int n, int lda, int incx)
+{
+    int size_a = lda * n, size_x = (n - 1) * incx + 1;
+
+    float *a = malloc(size_a * sizeof(float));
+    float *b = malloc(size_x * sizeof(float));
+    float *x = malloc(size_x * sizeof(float));
+
+    // small off diagonal entries keep op(a) well conditioned; with a unit diagonal the stored one must be ignored
+    for (int j = 0; j < n; j++)
+        for (int i = 0; i < lda; i++)
+            a[j * lda + i] = i == j ? (diag == GLBLAS_DIAG_UNIT ? 1000.f : 1.f + (i % 3) * .5f) : ((i * 7 + j * 3) % 13 - 6) * (.5f / n);
+    for (int i = 0; i < size_x; i++)
+        b[i] = (i % 7) - 3.f;
+
+    glblasMemory_t da = glblasMalloc(ctx, size_a * sizeof(float));
+    glblasMemory_t dx = glblasMalloc(ctx, size_x * sizeof(float));
+    glblasMemcpy(da, a, size_a * sizeof(float), glblasMemcpyInfer);
+    glblasMemcpy(dx, b, size_x * sizeof(float), glblasMemcpyInfer);
+
+    assert(glblasStrsv(uplo, trans, diag, n, da, lda, dx, incx) == GLBLAS_STATUS_SUCCESS);
+    glblasMemcpy(x, dx, size_x * sizeof(float), glblasMemcpyInfer);
+
+    float err = 0.f;
+    for (int i = 0; i < n; i++) {
+        double acc = 0.0;
+        for (int l = 0; l < n; l++)
+            acc += (double)op_tri(a, lda, uplo, trans, diag, i, l) * x[l * incx];
+        err = fmaxf(err, fabsf((float)acc - b[i * incx]) / (1.f + fabsf(b[i * incx])));
+    }
+    // elements between the strided ones stay as they were
+    for (int i = 0; i < size_x; i++)
+        if (i % incx && x[i] != b[i])
+            err = fmaxf(err, 1.f);
+
+    printf("strsv %s %c %s n = %d, lda = %d, incx = %d: max residual %g\n", uplo == GLBLAS_FILL_MODE_LOWER ? "lower" : "upper", trans == GLBLAS_OP_N ? 'N' : 'T', diag == GLBLAS_DIAG_UNIT ? "unit" : "non-unit", n, lda, incx, err);
+    if (!(err <= 1e-4f))
+        failures++;
+
+    glblasFree(da);
+    glblasFree(dx);
+    free(a);
+    free(b);
+    free(x);
+}
+
+int main()
+{
+    // device buffers are laid out in rows of 128 texels
+    glblasStatus_t status;
+    glblasHandle_t ctx;
+
+    assert((status = glblasCreate(&ctx, 128, 128)) == GLBLAS_STATUS_SUCCESS);
+
+    for (int uplo = 0; uplo < 2; uplo++) {
+        for (int trans = 0; trans < 2; trans++) {
+            for (int diag = 0; diag < 2; diag++) {
+                run(ctx, uplo, trans, diag, 5, 5, 1);
+                // more than one diagonal block
+                run(ctx, uplo, trans, diag, 77, 79, 2);
+            }
+        }
+    }
+
+    // automatically frees buffers, user may use `glblasFree` instead
+    glblasDestroy(ctx);
+
+    puts(failures ? "FAILED" : "OK");
+
+    return failures != 0;
+}
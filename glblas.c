@@ -21,16 +21,25 @@
 #include "glblas.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 #include <epoxy/egl.h>
 // #include <EGL/egl.h>
 
 #define FLOATS_PER_PIXEL 4
 
+// bytes of pooled temporaries a context keeps around by default
+#define GLBLAS_SCRATCH_DEFAULT_LIMIT (64 * 1024 * 1024)
+
 #define GLBLAS_ASSERT(x, ...) \
     do { \
         if (!(x)) { \
@@ -61,16 +70,316 @@ typedef enum _glblas_internal_shader_op {
     OP_SCOPY,
     OP_SAXPY,
     OP_SDOT,
-    OP_SDOTV2_MUL,
-    OP_SDOTV2_SUM,
     OP_SASUM,
+    OP_REDUCE,
+    OP_REDUCE_FINAL,
     OP_SGEMM,
-    OP_SGEMM4x4,
-    OP_SGEMM4x4_R,
+    OP_MEMCPY,
+    OP_ISAMAX,
+    OP_ISAMAX_REDUCE,
+    OP_ISAMAX_FINAL,
+    OP_SNRM2,
+    OP_SNRM2_FINAL,
+    OP_SROT,
+    OP_SSWAP,
+    OP_SGEMV,
+    OP_SGEMV_PARTIAL,
+    OP_SGEMV_SUM,
+    OP_SGER,
+    OP_SSYRK,
+    OP_STRSM,
+
+    // compute shaders, GLBLAS_BACKEND_COMPUTE only
+    OP_CS_SSCAL,
+    OP_CS_SCOPY,
+    OP_CS_SAXPY,
+    OP_CS_SDOT,
+    OP_CS_SASUM,
+    OP_CS_REDUCE,
+    OP_CS_REDUCE_FINAL,
+    OP_CS_SGEMM,
+    OP_CS_ISAMAX,
+    OP_CS_ISAMAX_REDUCE,
+    OP_CS_ISAMAX_FINAL,
+    OP_CS_SNRM2,
+    OP_CS_SNRM2_FINAL,
+    OP_CS_SROT,
+    OP_CS_SSWAP,
+    OP_CS_SGEMV,
+    OP_CS_SGEMV_PARTIAL,
+    OP_CS_SGEMV_SUM,
+    OP_CS_SGER,
+    OP_CS_SSYRK,
+    OP_CS_STRSM,
 
     OP_MAX
 } _glblas_internal_shader_op;
 
+/*
+ * per-call scalars are uploaded through a single std140 uniform block instead
+ * of individual glUniform calls; every kernel declares the same block, and
+ * _glblas_internal_params mirrors its layout (all members are 4 bytes, vec2s
+ * sit on 8 byte boundaries).
+ */
+#define PARAMS_BINDING 0
+
+#define GLSL_PARAMS \
+    "layout(std140) uniform Params {\n" \
+    "    vec2 dims;\n" \
+    "    vec2 adims;\n" \
+    "    vec2 bdims;\n" \
+    "    float alpha;\n" \
+    "    float beta;\n" \
+    "    int max_index;\n" \
+    "    int incx;\n" \
+    "    int incy;\n" \
+    "    int m;\n" \
+    "    int n;\n" \
+    "    int k;\n" \
+    "    int lda;\n" /* M */ \
+    "    int ldb;\n" /* K */ \
+    "    int ldc;\n" /* M */ \
+    "    bool aT;\n" \
+    "    bool bT;\n" \
+    "    int offx;\n" \
+    "    int offy;\n" \
+    "    int scalar_mode;\n" \
+    "    int uplo;\n" \
+    "    int diag;\n" \
+    "    int offa;\n" \
+    "    int offb;\n" \
+    "    int offc;\n" \
+    "    int stridea;\n" \
+    "    int strideb;\n" \
+    "    int stridec;\n" \
+    "    int batch;\n" \
+    "    vec4 rot;\n" /* h11, h21, h12, h22 */ \
+    "};\n"
+
+typedef struct _glblas_internal_params {
+    float dims[2];
+    float adims[2];
+    float bdims[2];
+    float alpha;
+    float beta;
+    int max_index;
+    int incx;
+    int incy;
+    int m;
+    int n;
+    int k;
+    int lda;
+    int ldb;
+    int ldc;
+    int aT;
+    int bT;
+    int offx;
+    int offy;
+    int scalar_mode;
+    int uplo;
+    int diag;
+    int offa;
+    int offb;
+    int offc;
+    int stridea;
+    int strideb;
+    int stridec;
+    int batch;
+    int pad[1];
+    float rot[4];
+} _glblas_internal_params;
+
+/*
+ * in GLBLAS_POINTER_MODE_DEVICE the _v2 kernels read alpha/beta from the first
+ * float of a device buffer instead of the params block; scalar_mode says which.
+ * kernels that take scalars include GLSL_SCALARS and use s_alpha/s_beta.
+ */
+#define SCALAR_ALPHA_DEVICE 1
+#define SCALAR_BETA_DEVICE 2
+
+#define GLSL_SCALARS \
+    "uniform sampler2D alpha_ptr;\n" \
+    "uniform sampler2D beta_ptr;\n" \
+    "float load_alpha()\n" \
+    "{\n" \
+    "    return (scalar_mode & 1) != 0 ? texelFetch(alpha_ptr, ivec2(0, 0), 0).r : alpha;\n" \
+    "}\n" \
+    "float load_beta()\n" \
+    "{\n" \
+    "    return (scalar_mode & 2) != 0 ? texelFetch(beta_ptr, ivec2(0, 0), 0).r : beta;\n" \
+    "}\n"
+
+/*
+ * shader variants: every op's source is compiled once per variant it is used
+ * with, behind a "#version" line and one "#define" per variant bit, so the
+ * common cases (unit stride, no transposes, beta == 0, alpha == 1) compile to
+ * straight-line code instead of branching on params at runtime. alpha/beta
+ * bits are only set for host scalars, device scalars take the general path.
+ */
+#define VARIANT_UNIT_STRIDE 1
+#define VARIANT_A_TRANS     2
+#define VARIANT_B_TRANS     4
+#define VARIANT_BETA_ZERO   8
+#define VARIANT_ALPHA_ONE   16
+#define VARIANT_ARGMIN      32
+#define VARIANT_MAX         64
+
+static const char *const variant_defines[] = {
+    "#define UNIT_STRIDE\n",
+    "#define A_TRANS\n",
+    "#define B_TRANS\n",
+    "#define BETA_ZERO\n",
+    "#define ALPHA_ONE\n",
+    "#define ARGMIN\n"
+};
+
+// lanes(t, inc): which floats of texel t are below max_index and on the stride
+#define GLSL_VARIANT \
+    "#ifdef ALPHA_ONE\n" \
+    "#define SCALE_ALPHA(v) (v)\n" \
+    "#else\n" \
+    "#define SCALE_ALPHA(v) (load_alpha() * (v))\n" \
+    "#endif\n" \
+    "bvec4 lanes(int t, int inc)\n" \
+    "{\n" \
+    "    ivec4 i = ivec4(t * 4) + ivec4(0, 1, 2, 3);\n" \
+    "#ifdef UNIT_STRIDE\n" \
+    "    return lessThan(i, ivec4(max_index));\n" \
+    "#else\n" \
+    "    return bvec4(ivec4(lessThan(i, ivec4(max_index))) & ivec4(equal(i % inc, ivec4(0))));\n" \
+    "#endif\n" \
+    "}\n"
+
+// inputs are addressed by element or texel index, so their layout doesn't have to match the output's
+#define GLSL_FETCH \
+    "vec4 fetch4(sampler2D s, int t)\n" \
+    "{\n" \
+    "    int w = textureSize(s, 0).x;\n" \
+    "    return texelFetch(s, ivec2(t % w, t / w), 0);\n" \
+    "}\n" \
+    "float fetch(sampler2D s, int i)\n" \
+    "{\n" \
+    "    return fetch4(s, i / 4)[i % 4];\n" \
+    "}\n"
+
+// op(a)[i][l], op(b)[l][j] and alpha*acc + beta*c for the sgemm kernels, offa/offb start a sub-matrix
+#define GLSL_GEMM_INDEX \
+    "#ifdef A_TRANS\n" \
+    "#define A_INDEX(i, l) (offa + lda * (i) + (l))\n" \
+    "#else\n" \
+    "#define A_INDEX(i, l) (offa + lda * (l) + (i))\n" \
+    "#endif\n" \
+    "#ifdef B_TRANS\n" \
+    "#define B_INDEX(l, j) (offb + ldb * (l) + (j))\n" \
+    "#else\n" \
+    "#define B_INDEX(l, j) (offb + ldb * (j) + (l))\n" \
+    "#endif\n"
+#define GLSL_GEMM \
+    GLSL_GEMM_INDEX \
+    "vec4 gemm_result(vec4 acc, vec4 c)\n" \
+    "{\n" \
+    "#ifdef BETA_ZERO\n" \
+    "    return SCALE_ALPHA(acc);\n" \
+    "#else\n" \
+    "    float s_beta = load_beta();\n" \
+    "    return SCALE_ALPHA(acc) + (s_beta != 0.0 ? s_beta * c : vec4(0.0));\n" \
+    "#endif\n" \
+    "}\n"
+
+#define MAX_TEXTURE_UNITS 6
+// a kernel samples every buffer it writes, so it never has more targets than texture units
+#define MAX_RENDER_TARGETS MAX_TEXTURE_UNITS
+
+// shadow copy of the gl state the kernels touch, used to skip redundant binds
+typedef struct _glblas_internal_state {
+    int viewport_width;
+    int viewport_height;
+    unsigned int program;
+    unsigned int active_texture;
+    unsigned int textures[MAX_TEXTURE_UNITS];
+    unsigned int framebuffer;
+    unsigned int vertex_array;
+    unsigned int image;
+    _glblas_internal_params params;
+    bool params_valid;
+
+    size_t elided;
+} _glblas_internal_state;
+
+#define TRANSFER_RING_SIZE 4
+
+typedef struct _glblas_internal_transfer {
+    unsigned int pbo;
+    size_t capacity;
+
+    GLsync fence;
+
+    // host destination of a pending download, NULL for uploads
+    void *dst;
+    size_t size;
+} _glblas_internal_transfer;
+
+/*
+ * deferred execution: in GLBLAS_EXECUTION_DEFERRED, unit-stride sscal, saxpy
+ * and scopy calls with host scalars are appended to context->fusion instead
+ * of running. the recorded chain is a dag over buffer versions: each op
+ * reads the latest value of its operands, so the chain runs as one generated
+ * kernel that loads every buffer's texel once, applies the ops in registers
+ * and stores the buffers that were written; k ops cost one pass, not k.
+ * make_current flushes, so every other entry point sees the chain's results.
+ */
+#define FUSE_MAX_OPS 16
+#define FUSE_MAX_BUFFERS MAX_RENDER_TARGETS
+#define FUSE_PROGRAM_CACHE 16
+#define FUSED_BINDING 1
+
+typedef enum _glblas_internal_fused_kind {
+    FUSE_SCAL,
+    FUSE_COPY,
+    FUSE_AXPY
+} _glblas_internal_fused_kind;
+
+// y = alpha*y, y = x or y = alpha*x + y over the first max_index floats; x, y are buffer slots
+typedef struct _glblas_internal_fused_op {
+    _glblas_internal_fused_kind kind;
+    int x;
+    int y;
+} _glblas_internal_fused_op;
+
+// std140 mirror of the generated kernels' Fused block (vec4 alpha[4], ivec4 max_index[4], ...)
+typedef struct _glblas_internal_fused_params {
+    float alpha[FUSE_MAX_OPS];
+    int max_index[FUSE_MAX_OPS];
+    int width;
+    int texels;
+    int pad[2];
+} _glblas_internal_fused_params;
+
+typedef struct _glblas_internal_fusion {
+    _glblas_internal_fused_op ops[FUSE_MAX_OPS];
+    int n_ops;
+
+    // buffer slot i is sampled on unit i; written slots are stored back
+    struct _glblas_internal_buffer *buffers[FUSE_MAX_BUFFERS];
+    bool written[FUSE_MAX_BUFFERS];
+    int n_buffers;
+
+    _glblas_internal_fused_params params;
+
+    // height of the written textures; with params.width, the fragment backend's render target size
+    int height;
+
+    // the Fused block's buffer
+    unsigned int UBO;
+
+    // generated programs by source hash, replaced round-robin
+    struct {
+        uint64_t hash;
+        unsigned int program;
+    } programs[FUSE_PROGRAM_CACHE];
+    int program_next;
+} _glblas_internal_fusion;
+
 typedef struct _glblas_internal_context {
     EGLDisplay dpy;
     EGLint minor, major;
@@ -81,13 +390,48 @@ typedef struct _glblas_internal_context {
     EGLSurface surface;
     EGLContext egl_context;
 
-    int pbuffer_width;
-    int pbuffer_height;
-    void *pbuffer_host;
+    // buffer layout limits: texels per row and rows per texture
+    int max_width;
+    int max_height;
 
     unsigned int VAO;
     unsigned int VBO;
     unsigned int EBO;
+    unsigned int UBO;
+
+    // programs are per context, gl objects aren't shared between handles; built on first use
+    unsigned int programs[OP_MAX][VARIANT_MAX];
+    unsigned int vertex_shader;
+
+    // program binary cache, cache_dir is empty when disabled
+    char cache_dir[PATH_MAX];
+    uint64_t driver_hash;
+
+    bool has_copy_image;
+
+    // compute kernels where the context supports them, fragment kernels otherwise
+    glblasBackend_t backend;
+
+    _glblas_internal_state state;
+
+    // textures/fbos released by kernels, most recently released first
+    struct _glblas_internal_buffer *scratch;
+    size_t scratch_size;
+    size_t scratch_limit;
+
+    // pixel buffer objects staging glblasMemcpyAsync, reused round-robin
+    _glblas_internal_transfer transfers[TRANSFER_RING_SIZE];
+    int transfer_next;
+
+    // how scalar arguments/results are passed, and the one-texel pbo host mode results are read through
+    glblasPointerMode_t pointer_mode;
+    unsigned int readback;
+
+    glblasExecutionMode_t execution_mode;
+    _glblas_internal_fusion fusion;
+
+    // framebuffer the fragment kernels with several outputs attach their targets to
+    unsigned int mrt_framebuffer;
 } _glblas_internal_context;
 
 typedef struct _glblas_internal_buffer {
@@ -98,21 +442,49 @@ typedef struct _glblas_internal_buffer {
     size_t size;
     int width;
     int height;
+    unsigned int format;
 
     bool is_padded;
 
+    glblasMemory_t handle;
+
     unsigned int framebuffer;
     unsigned int texture_colorbuffer;
 } _glblas_internal_buffer;
 
-typedef struct _glblas_internal_shader {
-    const char * const src;
-    unsigned int id;
-    unsigned int program;
-} _glblas_internal_shader;
+// alpha/beta as a kernel sees them: a value, or a device buffer whose first float holds it
+typedef struct _glblas_internal_scalar {
+    float value;
+    struct _glblas_internal_buffer *buffer;
+} _glblas_internal_scalar;
+
+typedef struct _glblas_internal_event {
+    _glblas_internal_context *context;
+
+    // NULL until recorded
+    GLsync fence;
+} _glblas_internal_event;
+
+static const struct {
+    const char *name;
+    int unit;
+} sampler_units[] = {
+    { "x", 0 },
+    { "y", 1 },
+    { "a", 0 },
+    { "b", 1 },
+    { "c", 2 },
+    { "alpha_ptr", 3 },
+    { "beta_ptr", 4 },
+    { "x0", 0 },
+    { "x1", 1 },
+    { "x2", 2 },
+    { "x3", 3 },
+    { "x4", 4 },
+    { "x5", 5 }
+};
 
 static const char *const glblas_vs_src_generic = 
-    "#version 330 core\n"
     "layout (location = 0) in vec3 aPos;\n"
     "layout (location = 1) in vec2 aTexCoord;\n"
     "out vec2 TexCoord;\n"
@@ -122,480 +494,1405 @@ static const char *const glblas_vs_src_generic =
     "   TexCoord = aTexCoord;\n"
     "}";
 
+/*
+ * element-wise kernels draw one fragment per texel of the output, in the
+ * output's own layout (see draw), so texel t holds elements [4t, 4t + 4).
+ */
 static const char *const glblas_fs_src_sscal =
-    "#version 330 core\n"
     "out vec4 FragColor;\n"
-    "in vec2 TexCoord;\n"
+    GLSL_PARAMS
+    GLSL_SCALARS
+    GLSL_VARIANT
     "uniform sampler2D x;\n"
-    "uniform float alpha;\n"
-    "uniform int incx;\n"
-    "uniform vec2 dims;\n"
-    "uniform int max_index;\n"
     "void main()\n"
     "{\n"
-    "   int index = int(gl_FragCoord.y - 0.5) * int(dims.x) + int(gl_FragCoord.x - 0.5) * 4;\n"
-    "   vec4 vx = texture(x, TexCoord);\n"
-    "   vx.r = ((index + 0) > max_index || (index + 0) % incx != 0) ? vx.r : vx.r * alpha;\n"
-    "   vx.g = ((index + 1) > max_index || (index + 1) % incx != 0) ? vx.g : vx.g * alpha;\n"
-    "   vx.b = ((index + 2) > max_index || (index + 2) % incx != 0) ? vx.b : vx.b * alpha;\n"
-    "   vx.a = ((index + 3) > max_index || (index + 3) % incx != 0) ? vx.a : vx.a * alpha;\n"
-    "   FragColor = vx;\n"
+    "    int t = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 vx = texelFetch(x, ivec2(gl_FragCoord.xy), 0);\n"
+    "    FragColor = mix(vx, vx * load_alpha(), lanes(t, incx));\n"
     "}";
 
+// y[i] = x[(i / incy) * incx] for the i < max_index on y's stride
 static const char *const glblas_fs_src_scopy =
-    "#version 330 core\n"
     "out vec4 FragColor;\n"
-    "in vec2 TexCoord;\n"
+    GLSL_PARAMS
+    GLSL_VARIANT
     "uniform sampler2D x;\n"
     "uniform sampler2D y;\n"
-    "uniform vec2 dims;\n"
-    "uniform int max_index;\n"
+    GLSL_FETCH
     "void main()\n"
     "{\n"
-    "   int index = int(gl_FragCoord.y - 0.5) * int(dims.x) + int(gl_FragCoord.x - 0.5) * 4;\n"
-    "   vec2 xTexCoord;\n"
-    "   vec4 vx = texture(x, TexCoord);\n"
-    "   vec4 vy = texture(y, TexCoord);\n"
-    "   vy.r = ((index + 0) > max_index) ? vy.r : vx.r;\n"
-    "   vy.g = ((index + 1) > max_index) ? vy.g : vx.g;\n"
-    "   vy.b = ((index + 2) > max_index) ? vy.b : vx.b;\n"
-    "   vy.a = ((index + 3) > max_index) ? vy.a : vx.a;\n"
-    "   FragColor = vy;\n"
+    "    int t = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 vy = texelFetch(y, ivec2(gl_FragCoord.xy), 0);\n"
+    "#ifdef UNIT_STRIDE\n"
+    "    vec4 vx = fetch4(x, t);\n"
+    "#else\n"
+    "    vec4 vx;\n"
+    "    for (int l = 0; l < 4; l++)\n"
+    "        vx[l] = fetch(x, ((t * 4 + l) / incy) * incx);\n"
+    "#endif\n"
+    "    FragColor = mix(vy, vx, lanes(t, incy));\n"
     "}";
 
-static const char *const glblas_fs_src_scopyv2 =
-    "#version 330 core\n"
+static const char *const glblas_fs_src_saxpy =
     "out vec4 FragColor;\n"
-    "in vec2 TexCoord;\n"
+    GLSL_PARAMS
+    GLSL_SCALARS
+    GLSL_VARIANT
     "uniform sampler2D x;\n"
     "uniform sampler2D y;\n"
-    "uniform int incx;\n"
-    "uniform int incy;\n"
-    "uniform vec2 dims;\n"
-    "uniform int max_index;\n"
-    "#define kernel(offs, elem) \\\n"
-    "    if ((index + offs) < max_index && (index + offs) % incy == 0) { \\\n"
-    "        int xindex = ((index + offs) + ((index + offs) / incy) * (incx - incy)); \\\n"
-    "        xTexCoord.y = float((xindex / 4) / int(dims.x)) / dims.y; \\\n"
-    "        xTexCoord.x = float((xindex / 4) % int(dims.x)) / dims.x; \\\n"
-    "        vec4 vx = texture(x, xTexCoord); \\\n"
-    "        float val; \\\n"
-    "        switch (xindex % 4) { \\\n"
-    "        case 0: val = vx.r; break; \\\n"
-    "        case 1: val = vx.g; break; \\\n"
-    "        case 2: val = vx.b; break; \\\n"
-    "        case 3: val = vx.a; break; \\\n"
-    "        } \\\n"
-    "        vy.elem = val; \\\n"
-    "    }\n"
+    GLSL_FETCH
     "void main()\n"
     "{\n"
-    "    int index = int(gl_FragCoord.y - 0.5) * int(dims.x) + int(gl_FragCoord.x - 0.5) * 4;\n"
-    "    vec4 vy = texture(y, TexCoord);\n"
-    "    vec2 xTexCoord;\n"
-    "    kernel(0, r);\n"
-    "    kernel(1, g);\n"
-    "    kernel(2, b);\n"
-    "    kernel(3, a);\n"
-    "    FragColor = vy;\n"
+    "    int t = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 vy = texelFetch(y, ivec2(gl_FragCoord.xy), 0);\n"
+    "#ifdef UNIT_STRIDE\n"
+    "    vec4 vx = fetch4(x, t);\n"
+    "#else\n"
+    "    vec4 vx;\n"
+    "    for (int l = 0; l < 4; l++)\n"
+    "        vx[l] = fetch(x, ((t * 4 + l) / incy) * incx);\n"
+    "#endif\n"
+    "    FragColor = mix(vy, vy + SCALE_ALPHA(vx), lanes(t, incy));\n"
     "}";
 
-static const char *const glblas_fs_src_saxpy =
-    "#version 330 core\n"
-    "out vec4 FragColor;\n"
-    "in vec2 TexCoord;\n"
+/*
+ * x' = h11*x + h12*y, y' = h21*x + h22*y (rot is column major) in one pass:
+ * x and y are render targets 0 and 1 of the same layout, and each fragment
+ * reads its own texel of both before writing either. incx == incy.
+ */
+static const char *const glblas_fs_src_srot =
+    "layout(location = 0) out vec4 outx;\n"
+    "layout(location = 1) out vec4 outy;\n"
+    GLSL_PARAMS
+    GLSL_VARIANT
     "uniform sampler2D x;\n"
     "uniform sampler2D y;\n"
-    "uniform float alpha;\n"
-    "uniform vec2 dims;\n"
-    "uniform int max_index;\n"
     "void main()\n"
     "{\n"
-    "   int index = int(gl_FragCoord.y - 0.5) * int(dims.x) + int(gl_FragCoord.x - 0.5) * 4;\n"
-    "   vec2 xTexCoord;\n"
-    "   vec4 vx = texture(x, TexCoord);\n"
-    "   vec4 vy = texture(y, TexCoord);\n"
-    "   vy.r = ((index + 0) > max_index) ? vy.r : vx.r * alpha + vy.r;\n"
-    "   vy.g = ((index + 1) > max_index) ? vy.g : vx.g * alpha + vy.g;\n"
-    "   vy.b = ((index + 2) > max_index) ? vy.b : vx.b * alpha + vy.b;\n"
-    "   vy.a = ((index + 3) > max_index) ? vy.a : vx.a * alpha + vy.a;\n"
-    "   FragColor = vy;\n"
+    "    int t = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 vx = texelFetch(x, ivec2(gl_FragCoord.xy), 0);\n"
+    "    vec4 vy = texelFetch(y, ivec2(gl_FragCoord.xy), 0);\n"
+    "    bvec4 live = lanes(t, incx);\n"
+    "    outx = mix(vx, rot.x * vx + rot.z * vy, live);\n"
+    "    outy = mix(vy, rot.y * vx + rot.w * vy, live);\n"
     "}";
 
-static const char *const glblas_fs_src_saxpyv2 =
-    "#version 330 core\n"
-    "out vec4 FragColor;\n"
-    "in vec2 TexCoord;\n"
+// the same shape exchanging x and y; a select rather than srot's (0, 1, 1, 0), so inf/nan move untouched
+static const char *const glblas_fs_src_sswap =
+    "layout(location = 0) out vec4 outx;\n"
+    "layout(location = 1) out vec4 outy;\n"
+    GLSL_PARAMS
+    GLSL_VARIANT
     "uniform sampler2D x;\n"
     "uniform sampler2D y;\n"
-    "uniform float alpha;\n"
-    "uniform int incx;\n"
-    "uniform int incy;\n"
-    "uniform vec2 dims;\n"
-    "uniform int max_index;\n"
-    "#define kernel(offs, elem) \\\n"
-    "    if ((index + offs) < max_index && (index + offs) % incy == 0) { \\\n"
-    "        int xindex = ((index + offs) + ((index + offs) / incy) * (incx - incy)); \\\n"
-    "        xTexCoord.y = float((xindex / 4) / int(dims.x)) / dims.y; \\\n"
-    "        xTexCoord.x = float((xindex / 4) % int(dims.x)) / dims.x; \\\n"
-    "        vec4 vx = texture(x, xTexCoord); \\\n"
-    "        float val; \\\n"
-    "        switch (xindex % 4) { \\\n"
-    "        case 0: val = vx.r; break; \\\n"
-    "        case 1: val = vx.g; break; \\\n"
-    "        case 2: val = vx.b; break; \\\n"
-    "        case 3: val = vx.a; break; \\\n"
-    "        } \\\n"
-    "        vy.elem += val * alpha; \\\n"
-    "    }\n"
     "void main()\n"
     "{\n"
-    "    int index = int(gl_FragCoord.y - 0.5) * int(dims.x) + int(gl_FragCoord.x - 0.5) * 4;\n"
-    "    vec4 vy = texture(y, TexCoord);\n"
-    "    vec2 xTexCoord;\n"
-    "    kernel(0, r);\n"
-    "    kernel(1, g);\n"
-    "    kernel(2, b);\n"
-    "    kernel(3, a);\n"
-    "    FragColor = vy;\n"
+    "    int t = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 vx = texelFetch(x, ivec2(gl_FragCoord.xy), 0);\n"
+    "    vec4 vy = texelFetch(y, ivec2(gl_FragCoord.xy), 0);\n"
+    "    bvec4 live = lanes(t, incx);\n"
+    "    outx = mix(vx, vy, live);\n"
+    "    outy = mix(vy, vx, live);\n"
     "}";
 
-// don't use
+/*
+ * reductions: every pass is drawn over a target of one fragment per output
+ * texel, and fragment f folds REDUCE_FOLD input texels (64 elements in the first
+ * pass) into a vec4 of partial sums. inputs are addressed by texel index
+ * through texelFetch, so the source and target layouts don't have to match.
+ */
+#define REDUCE_FOLD 16
+
+// first pass of sdot: partial sums of x[e*incx] * y[e*incy] for e*incy < max_index
 static const char *const glblas_fs_src_sdot =
-    "#version 330 core\n"
     "out vec4 FragColor;\n"
     "in vec2 TexCoord;\n"
+    GLSL_PARAMS
     "uniform sampler2D x;\n"
     "uniform sampler2D y;\n"
-    "uniform int incx;\n"
-    "uniform int incy;\n"
-    "uniform vec2 dims;\n"
-    "uniform int max_index;\n"
+    GLSL_FETCH
     "void main()\n"
     "{\n"
-    "   int index = int(gl_FragCoord.y - 0.5) * int(dims.x) + int(gl_FragCoord.x - 0.5) * 4;\n"
-    "   if (index != 0) { FragColor = vec4(1, 0, 0, 0); return; }\n"
-    "   int ix = 0;\n"
-    "   int iy = 0;\n"
-    "   vec4 result = vec4(0, 0, 0, 0);\n"
-    "   for (int i = 0; i < max_index; i += 4) {\n"
-    "       vec2 xTexCoord;\n"
-    "       xTexCoord.y = floor((ix) / dims.x) / dims.y;\n"
-    "       xTexCoord.x = ((ix) - xTexCoord.y * dims.x * dims.y) / dims.x;\n"
-    "       vec2 yTexCoord;\n"
-    "       yTexCoord.y = floor((iy) / dims.x) / dims.y;\n"
-    "       yTexCoord.x = ((iy) - yTexCoord.y * dims.x * dims.y) / dims.x;\n"
-    "       vec4 vx = texture(x, xTexCoord);\n"
-    "       vec4 vy = texture(y, yTexCoord);\n"
-    "       vec4 vz = vx * vy;\n"
-    "       result.r += ((ix + 0) % incx != 0 || (iy + 0) % incy != 0) ? 0 : vz.r;\n"
-    "       result.r += ((ix + 1) % incx != 0 || (iy + 1) % incy != 0) ? 0 : vz.g;\n"
-    "       result.r += ((ix + 2) % incx != 0 || (iy + 2) % incy != 0) ? 0 : vz.b;\n"
-    "       result.r += ((ix + 3) % incx != 0 || (iy + 3) % incy != 0) ? 0 : vz.a;\n"
-    "       ix += incx * 4;\n"
-    "       iy += incy * 4;\n"
-    "   }\n"
-    "   FragColor = result;\n"
+    "    int f = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 acc = vec4(0.0);\n"
+    "#ifdef UNIT_STRIDE\n"
+    "    for (int j = 0; j < 16; j++) {\n"
+    "        int t = f * 16 + j;\n"
+    "        bvec4 live = lessThan(ivec4(t * 4) + ivec4(0, 1, 2, 3), ivec4(max_index));\n"
+    "        if (!live.x) break;\n"
+    "        acc += mix(vec4(0.0), fetch4(x, t) * fetch4(y, t), live);\n"
+    "    }\n"
+    "#else\n"
+    "    for (int j = 0; j < 64; j++) {\n"
+    "        int e = f * 64 + j;\n"
+    "        if (e * incy >= max_index) break;\n"
+    "        acc[j % 4] += fetch(x, e * incx) * fetch(y, e * incy);\n"
+    "    }\n"
+    "#endif\n"
+    "    FragColor = acc;\n"
     "}";
 
-static const char *const glblas_fs_src_sdotv2_mul =
-    "#version 330 core\n"
+// first pass of sasum: partial sums of |x[e*incx]| for e*incx < max_index
+static const char *const glblas_fs_src_sasum =
     "out vec4 FragColor;\n"
     "in vec2 TexCoord;\n"
+    GLSL_PARAMS
     "uniform sampler2D x;\n"
-    "uniform sampler2D y;\n"
-    "uniform int incx;\n"
-    "uniform int incy;\n"
-    "uniform vec2 dims;\n"
-    "uniform int max_index;\n"
+    GLSL_FETCH
     "void main()\n"
     "{\n"
-    "   int index = int(gl_FragCoord.y - 0.5) * int(dims.x) + int(gl_FragCoord.x - 0.5) * 4;\n"
-    "   vec2 xTexCoord;\n"
-    "   vec4 vx = texture(x, TexCoord);\n"
-    "   vec4 vy = texture(y, TexCoord);\n"
-    "   vy.r = ((index + 0) > max_index) ? vy.r : vx.r * vy.r;\n"
-    "   vy.g = ((index + 1) > max_index) ? vy.g : vx.g * vy.g;\n"
-    "   vy.b = ((index + 2) > max_index) ? vy.b : vx.b * vy.b;\n"
-    "   vy.a = ((index + 3) > max_index) ? vy.a : vx.a * vy.a;\n"
-    "   FragColor = vy;\n"
+    "    int f = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 acc = vec4(0.0);\n"
+    "#ifdef UNIT_STRIDE\n"
+    "    for (int j = 0; j < 16; j++) {\n"
+    "        int t = f * 16 + j;\n"
+    "        bvec4 live = lessThan(ivec4(t * 4) + ivec4(0, 1, 2, 3), ivec4(max_index));\n"
+    "        if (!live.x) break;\n"
+    "        acc += mix(vec4(0.0), abs(fetch4(x, t)), live);\n"
+    "    }\n"
+    "#else\n"
+    "    for (int j = 0; j < 64; j++) {\n"
+    "        int e = f * 64 + j;\n"
+    "        if (e * incx >= max_index) break;\n"
+    "        acc[j % 4] += abs(fetch(x, e * incx));\n"
+    "    }\n"
+    "#endif\n"
+    "    FragColor = acc;\n"
     "}";
 
-static const char *const glblas_fs_src_sdotv3_mul =
-    "#version 330 core\n"
+/*
+ * snrm2 uses blue's algorithm as in lapack's snrm2: squares are summed in three
+ * accumulators, (|x| * SSML)^2 for |x| < TSML, |x|^2 for the middle range and
+ * (|x| * SBIG)^2 for |x| > TBIG, so no partial sum over- or underflows. the
+ * accumulators are plain sums, kept in lanes (x, y, z), so the sum passes of
+ * reduce fold them unchanged; only the first and final passes differ.
+ * the constants are 2^-63, 2^52, 2^75 and 2^-76.
+ */
+#define GLSL_NRM2 \
+    "const float TSML = 1.0842021724855044e-19;\n" \
+    "const float TBIG = 4503599627370496.0;\n" \
+    "const float SSML = 3.777893186295716e22;\n" \
+    "const float SBIG = 1.3234889800848443e-23;\n" \
+    "vec4 nrm2_sums(vec4 v)\n" \
+    "{\n" \
+    "    vec4 ax = abs(v);\n" \
+    "    bvec4 small = lessThan(ax, vec4(TSML));\n" \
+    "    bvec4 big = greaterThan(ax, vec4(TBIG));\n" \
+    "    vec4 sml = mix(vec4(0.0), ax, small) * SSML;\n" \
+    "    vec4 med = mix(mix(ax, vec4(0.0), small), vec4(0.0), big);\n" \
+    "    vec4 bg = mix(vec4(0.0), ax, big) * SBIG;\n" \
+    "    return vec4(dot(sml, sml), dot(med, med), dot(bg, bg), 0.0);\n" \
+    "}\n" \
+    "float nrm2(vec4 a)\n" \
+    "{\n" \
+    "    if (a.z > 0.0) {\n" \
+    "        if (a.y > 0.0 || isnan(a.y))\n" \
+    "            a.z += (a.y * SBIG) * SBIG;\n" \
+    "        return sqrt(a.z) / SBIG;\n" \
+    "    }\n" \
+    "    if (a.x > 0.0) {\n" \
+    "        if (a.y > 0.0 || isnan(a.y)) {\n" \
+    "            float ymed = sqrt(a.y);\n" \
+    "            float ysml = sqrt(a.x) / SSML;\n" \
+    "            float ymin = min(ymed, ysml);\n" \
+    "            float ymax = max(ymed, ysml);\n" \
+    "            return ymax * sqrt(1.0 + (ymin / ymax) * (ymin / ymax));\n" \
+    "        }\n" \
+    "        return sqrt(a.x) / SSML;\n" \
+    "    }\n" \
+    "    return sqrt(a.y);\n" \
+    "}\n"
+
+// first pass of snrm2: the three scaled sums of squares of x[e*incx] for e*incx < max_index
+static const char *const glblas_fs_src_snrm2 =
     "out vec4 FragColor;\n"
-    "in vec2 TexCoord;\n"
+    GLSL_PARAMS
     "uniform sampler2D x;\n"
-    "uniform sampler2D y;\n"
-    "uniform int incx;\n"
-    "uniform int incy;\n"
-    "uniform vec2 dims;\n"
-    "uniform int max_index;\n"
-    "#define kernel(offs, elem) \\\n"
-    "    if ((index + offs) < max_index && (index + offs) % incy == 0) { \\\n"
-    "        int xindex = ((index + offs) + ((index + offs) / incy) * (incx - incy)); \\\n"
-    "        xTexCoord.y = float((xindex / 4) / int(dims.x)) / dims.y; \\\n"
-    "        xTexCoord.x = float((xindex / 4) % int(dims.x)) / dims.x; \\\n"
-    "        vec4 vx = texture(x, xTexCoord); \\\n"
-    "        float val; \\\n"
-    "        switch (xindex % 4) { \\\n"
-    "        case 0: val = vx.r; break; \\\n"
-    "        case 1: val = vx.g; break; \\\n"
-    "        case 2: val = vx.b; break; \\\n"
-    "        case 3: val = vx.a; break; \\\n"
-    "        } \\\n"
-    "        vy.elem *= val; \\\n"
-    "    }\n"
+    GLSL_FETCH
+    GLSL_NRM2
     "void main()\n"
     "{\n"
-    "    int index = int(gl_FragCoord.y - 0.5) * int(dims.x) + int(gl_FragCoord.x - 0.5) * 4;\n"
-    "    vec4 vy = texture(y, TexCoord);\n"
-    "    vec2 xTexCoord;\n"
-    "    kernel(0, r);\n"
-    "    kernel(1, g);\n"
-    "    kernel(2, b);\n"
-    "    kernel(3, a);\n"
-    "    FragColor = vy;\n"
+    "    int f = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 acc = vec4(0.0);\n"
+    "#ifdef UNIT_STRIDE\n"
+    "    for (int j = 0; j < 16; j++) {\n"
+    "        int t = f * 16 + j;\n"
+    "        bvec4 live = lessThan(ivec4(t * 4) + ivec4(0, 1, 2, 3), ivec4(max_index));\n"
+    "        if (!live.x) break;\n"
+    "        acc += nrm2_sums(mix(vec4(0.0), fetch4(x, t), live));\n"
+    "    }\n"
+    "#else\n"
+    "    for (int j = 0; j < 64; j++) {\n"
+    "        int e = f * 64 + j;\n"
+    "        if (e * incx >= max_index) break;\n"
+    "        acc += nrm2_sums(vec4(fetch(x, e * incx), 0.0, 0.0, 0.0));\n"
+    "    }\n"
+    "#endif\n"
+    "    FragColor = acc;\n"
     "}";
 
-static const char *const glblas_fs_src_sdotv2_sum =
-    "#version 330 core\n"
+// later passes: sum texels [f*16, f*16 + 16) of the previous level, max_index texels in total
+static const char *const glblas_fs_src_reduce =
     "out vec4 FragColor;\n"
     "in vec2 TexCoord;\n"
+    GLSL_PARAMS
     "uniform sampler2D x;\n"
-    "uniform int incx;\n"
-    "uniform vec2 dims;\n"
-    "uniform int max_index;\n"
+    GLSL_FETCH
     "void main()\n"
     "{\n"
-    "   int index = int(gl_FragCoord.y - 0.5) * int(dims.x) + int(gl_FragCoord.x - 0.5);\n" // we want index of vector, so don't mul by 4
-    "   if (max_index == 1) {\n"
-    "       vec4 vy = abs(texture(x, TexCoord));\n"
-    "       FragColor = index == 0 ? vec4(vy.r + vy.g + vy.b + vy.a, 0, 0, 0) : vec4(1, 0, 0, 0);\n"
-    "       return;\n"
-    "   }\n"
-    "   int halfway = ((max_index / 4));\n" // to-do: document why this is 4 instead of 2?
-    "   if (index > halfway) { FragColor = vec4(0, 0, 0, 0); return; }\n"
-    "   vec2 xTexCoord;\n"
-    "   xTexCoord.y = float(((index + halfway) / incx) / int(dims.x)) / dims.y;\n"
-    "   xTexCoord.x = float(((index + halfway) / incx) % int(dims.x)) / dims.x;\n"
-    "   vec4 vx = (texture(x, xTexCoord));\n" // CURRENT + HALFWAY
-    "   vec4 vy = (texture(x, TexCoord));\n" // CURRENT
-    "   vy.r = ((index + 0) > max_index || (index + 0) % incx != 0) ? vy.r : vx.r + vy.r;\n"
-    "   vy.g = ((index + 1) > max_index || (index + 1) % incx != 0) ? vy.g : vx.g + vy.g;\n"
-    "   vy.b = ((index + 2) > max_index || (index + 2) % incx != 0) ? vy.b : vx.b + vy.b;\n"
-    "   vy.a = ((index + 3) > max_index || (index + 3) % incx != 0) ? vy.a : vx.a + vy.a;\n"
-    "   FragColor = vy;\n"
+    "    int f = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 acc = vec4(0.0);\n"
+    "    for (int j = 0; j < 16; j++) {\n"
+    "        int t = f * 16 + j;\n"
+    "        if (t >= max_index) break;\n"
+    "        acc += fetch4(x, t);\n"
+    "    }\n"
+    "    FragColor = acc;\n"
     "}";
 
-static const char *const glblas_fs_src_sasum =
-    "#version 330 core\n"
+// last pass: collapse the lanes of the single remaining texel
+static const char *const glblas_fs_src_reduce_final =
     "out vec4 FragColor;\n"
     "in vec2 TexCoord;\n"
+    GLSL_PARAMS
     "uniform sampler2D x;\n"
-    "uniform int incx;\n"
-    "uniform vec2 dims;\n"
-    "uniform int max_index;\n"
     "void main()\n"
     "{\n"
-    "   int index = int(gl_FragCoord.y - 0.5) * int(dims.x) + int(gl_FragCoord.x - 0.5);\n" // we want index of vector, so don't mul by 4
-    "   if (max_index == 1) {\n"
-    "       vec4 vy = abs(texture(x, TexCoord));\n"
-    "       FragColor = index == 0 ? vec4(vy.r + vy.g + vy.b + vy.a, 0, 0, 0) : vec4(1, 0, 0, 0);\n"
-    "       return;\n"
-    "   }\n"
-    "   int halfway = ((max_index / 4));\n" // to-do: document why this is 4 instead of 2?
-    "   if (index > halfway) { FragColor = vec4(0, 0, 0, 0); return; }\n"
-    "   vec2 xTexCoord;\n"
-    "   xTexCoord.y = float(((index + halfway) / incx) / int(dims.x)) / dims.y;\n"
-    "   xTexCoord.x = float(((index + halfway) / incx) % int(dims.x)) / dims.x;\n"
-    "   vec4 vx = abs(texture(x, xTexCoord));\n" // CURRENT + HALFWAY
-    "   vec4 vy = abs(texture(x, TexCoord));\n" // CURRENT
-    "   vy.r = ((index + 0) > max_index || (index + 0) % incx != 0) ? vy.r : vx.r + vy.r;\n"
-    "   vy.g = ((index + 1) > max_index || (index + 1) % incx != 0) ? vy.g : vx.g + vy.g;\n"
-    "   vy.b = ((index + 2) > max_index || (index + 2) % incx != 0) ? vy.b : vx.b + vy.b;\n"
-    "   vy.a = ((index + 3) > max_index || (index + 3) % incx != 0) ? vy.a : vx.a + vy.a;\n"
-    "   FragColor = vy;\n"
+    "    FragColor = vec4(dot(texelFetch(x, ivec2(0, 0), 0), vec4(1.0)));\n"
     "}";
 
+// last pass of snrm2: combine the three sums of the remaining texel
+static const char *const glblas_fs_src_snrm2_final =
+    "out vec4 FragColor;\n"
+    GLSL_PARAMS
+    "uniform sampler2D x;\n"
+    GLSL_NRM2
+    "void main()\n"
+    "{\n"
+    "    FragColor = vec4(nrm2(texelFetch(x, ivec2(0, 0), 0)));\n"
+    "}";
+
+/*
+ * isamax/isamin reduce (value, index) candidates instead of sums: a texel holds
+ * (|x[e]|, e / 4096, e % 4096, 0), so indices stay exact in float lanes, and
+ * e < 0 (.y < 0) marks an empty one. pick() keeps the larger (ARGMIN: smaller)
+ * value and the lower index on ties, so the fold order doesn't matter.
+ */
+#define GLSL_IAMAX \
+    "#ifdef ARGMIN\n" \
+    "#define BEATS(a, b) ((a) < (b))\n" \
+    "#else\n" \
+    "#define BEATS(a, b) ((a) > (b))\n" \
+    "#endif\n" \
+    "const vec4 none = vec4(0.0, -1.0, 0.0, 0.0);\n" \
+    "vec4 candidate(float v, int e)\n" \
+    "{\n" \
+    "    return vec4(abs(v), float(e / 4096), float(e % 4096), 0.0);\n" \
+    "}\n" \
+    "vec4 pick(vec4 a, vec4 b)\n" \
+    "{\n" \
+    "    if (b.y < 0.0) return a;\n" \
+    "    if (a.y < 0.0) return b;\n" \
+    "    if (BEATS(b.x, a.x)) return b;\n" \
+    "    if (b.x == a.x && (b.y < a.y || (b.y == a.y && b.z < a.z))) return b;\n" \
+    "    return a;\n" \
+    "}\n"
+
+// first pass of isamax: the best of elements [f*64, f*64 + 64) with e*incx < max_index
+static const char *const glblas_fs_src_isamax =
+    "out vec4 FragColor;\n"
+    GLSL_PARAMS
+    "uniform sampler2D x;\n"
+    GLSL_FETCH
+    GLSL_IAMAX
+    "void main()\n"
+    "{\n"
+    "    int f = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 best = none;\n"
+    "#ifdef UNIT_STRIDE\n"
+    "    for (int j = 0; j < 16; j++) {\n"
+    "        int t = f * 16 + j;\n"
+    "        if (t * 4 >= max_index) break;\n"
+    "        vec4 v = fetch4(x, t);\n"
+    "        for (int l = 0; l < 4 && t * 4 + l < max_index; l++)\n"
+    "            best = pick(best, candidate(v[l], t * 4 + l));\n"
+    "    }\n"
+    "#else\n"
+    "    for (int j = 0; j < 64; j++) {\n"
+    "        int e = f * 64 + j;\n"
+    "        if (e * incx >= max_index) break;\n"
+    "        best = pick(best, candidate(fetch(x, e * incx), e));\n"
+    "    }\n"
+    "#endif\n"
+    "    FragColor = best;\n"
+    "}";
+
+// later passes: the best of candidate texels [f*16, f*16 + 16), max_index texels in total
+static const char *const glblas_fs_src_isamax_reduce =
+    "out vec4 FragColor;\n"
+    GLSL_PARAMS
+    "uniform sampler2D x;\n"
+    GLSL_FETCH
+    GLSL_IAMAX
+    "void main()\n"
+    "{\n"
+    "    int f = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 best = none;\n"
+    "    for (int j = 0; j < 16; j++) {\n"
+    "        int t = f * 16 + j;\n"
+    "        if (t >= max_index) break;\n"
+    "        best = pick(best, fetch4(x, t));\n"
+    "    }\n"
+    "    FragColor = best;\n"
+    "}";
+
+// device pointer mode: the 1-based index of the remaining candidate, 0 if there is none
+static const char *const glblas_fs_src_isamax_final =
+    "out vec4 FragColor;\n"
+    GLSL_PARAMS
+    "uniform sampler2D x;\n"
+    "void main()\n"
+    "{\n"
+    "    vec4 best = texelFetch(x, ivec2(0, 0), 0);\n"
+    "    FragColor = vec4(best.y < 0.0 ? 0.0 : float(int(best.y) * 4096 + int(best.z) + 1));\n"
+    "}";
+
+/*
+ * sgemm, one fragment per texel of c. batch problems are stridea/b/c floats
+ * apart, problem p = e / stridec of c element e. when columns of c start on
+ * a texel (UNIT_STRIDE) the texel is rows i0..i0+3 of column j, and each step over k
+ * holds a 4x4 block of op(a) (4 rows by 4 l) in a mat4 and multiplies it by
+ * 4 elements of op(b): four vec4 loads of a and one of b where lda, ldb and
+ * the offsets allow, scalar fetches otherwise. k is masked to its end, rows
+ * past m and columns past n are left as they are. c columns that straddle
+ * texels fall back to one dot product per lane.
+ */
+#define GLSL_GEMM_BLOCK \
+    "mat4 load_a4(int base, int i0, int l, bvec4 in_range)\n" \
+    "{\n" \
+    "    mat4 t;\n" \
+    "    bool vec = lda % 4 == 0 && offa % 4 == 0 && stridea % 4 == 0;\n" \
+    "#ifdef A_TRANS\n" \
+    "    if (vec) {\n" \
+    "        for (int r = 0; r < 4; r++)\n" \
+    "            t[r] = mix(vec4(0.0), fetch4(a, (base + A_INDEX(i0 + r, l)) / 4), in_range);\n" \
+    "        return transpose(t);\n" \
+    "    }\n" \
+    "#else\n" \
+    "    if (vec) {\n" \
+    "        for (int c = 0; c < 4; c++)\n" \
+    "            t[c] = in_range[c] ? fetch4(a, (base + A_INDEX(i0, l + c)) / 4) : vec4(0.0);\n" \
+    "        return t;\n" \
+    "    }\n" \
+    "#endif\n" \
+    "    for (int c = 0; c < 4; c++)\n" \
+    "        for (int r = 0; r < 4; r++)\n" \
+    "            t[c][r] = in_range[c] ? fetch(a, base + A_INDEX(i0 + r, l + c)) : 0.0;\n" \
+    "    return t;\n" \
+    "}\n" \
+    "vec4 load_b4(int base, int l, int j, bvec4 in_range)\n" \
+    "{\n" \
+    "#ifndef B_TRANS\n" \
+    "    if (ldb % 4 == 0 && offb % 4 == 0 && strideb % 4 == 0)\n" \
+    "        return mix(vec4(0.0), fetch4(b, (base + B_INDEX(l, j)) / 4), in_range);\n" \
+    "#endif\n" \
+    "    vec4 v;\n" \
+    "    for (int c = 0; c < 4; c++)\n" \
+    "        v[c] = in_range[c] ? fetch(b, base + B_INDEX(l + c, j)) : 0.0;\n" \
+    "    return v;\n" \
+    "}\n"
+
 static const char *const glblas_fs_src_sgemm =
-    "#version 330 core\n"
     "out vec4 FragColor;\n"
-    "in vec2 TexCoord;\n"
+    GLSL_PARAMS
+    GLSL_SCALARS
+    GLSL_VARIANT
     "uniform sampler2D a;\n"
     "uniform sampler2D b;\n"
     "uniform sampler2D c;\n"
-    "uniform int lda;\n" // M
-    "uniform int ldb;\n" // K
-    "uniform int ldc;\n" // M
-    "uniform bool aT;\n"
-    "uniform bool bT;\n"
-    "uniform float alpha;\n"
-    "uniform float beta;\n"
-    "uniform vec2 dims\n; /* .x = M, .y = N */\n"
-    "uniform vec2 adims;\n"
-    "uniform vec2 bdims;\n"
-    "uniform int m;\n"
-    "uniform int n;\n"
-    "uniform int k;\n"
-    "uniform int max_index;\n"
-    "#define kernel(offs, elem) \\\n"
-    "    if ((index + offs) < max_index) { \\\n"
-    "        float val = 0; \\\n"
-    "        int i = (index + offs) % m; \\\n" // row
-    "        int j = (index + offs) / m; \\\n" // col
-    "        for (int l = 0; l < k; l++) { \\\n"
-    "            int aindex = aT ? lda * i + l : lda * l + i; \\\n"
-    "            int bindex = bT ? ldb * l + j : ldb * j + l; \\\n"
-    "            aTexCoord.y = float((aindex / 4) / ax) / ay; \\\n"
-    "            aTexCoord.x = float((aindex / 4) % ax) / ax; \\\n"
-    "            bTexCoord.y = float((bindex / 4) / bx) / by; \\\n"
-    "            bTexCoord.x = float((bindex / 4) % bx) / bx; \\\n"
-    "            vec4 va = texture(a, aTexCoord); \\\n"
-    "            vec4 vb = texture(b, bTexCoord); \\\n"
-    "            float v0, v1; \\\n"
-    "            switch (aindex % 4) { \\\n"
-    "            case 0: v0 = va.r; break; \\\n"
-    "            case 1: v0 = va.g; break; \\\n"
-    "            case 2: v0 = va.b; break; \\\n"
-    "            case 3: v0 = va.a; break; \\\n"
-    "            } \\\n"
-    "            switch (bindex % 4) { \\\n"
-    "            case 0: v1 = vb.r; break; \\\n"
-    "            case 1: v1 = vb.g; break; \\\n"
-    "            case 2: v1 = vb.b; break; \\\n"
-    "            case 3: v1 = vb.a; break; \\\n"
-    "            } \\\n"
-    "            val += v0 * v1; \\\n"
-    "        } \\\n"
-    "        vy.elem = (alpha * val) + (vy.elem * beta); \\\n"
+    GLSL_FETCH
+    GLSL_GEMM
+    GLSL_GEMM_BLOCK
+    "void main()\n"
+    "{\n"
+    "    int t = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 vc = texelFetch(c, ivec2(gl_FragCoord.xy), 0);\n"
+    "    vec4 acc = vec4(0.0);\n"
+    "#ifdef UNIT_STRIDE\n"
+    "    int e0 = t * 4 - offc;\n"
+    "    int p = e0 / stridec;\n"
+    "    int i0 = (e0 - p * stridec) % ldc;\n"
+    "    int j = (e0 - p * stridec) / ldc;\n"
+    "    bvec4 live = lessThan(ivec4(i0) + ivec4(0, 1, 2, 3), ivec4(e0 >= 0 && p < batch && j < n ? m : 0));\n"
+    "    if (!any(live)) {\n"
+    "        FragColor = vc;\n"
+    "        return;\n"
+    "    }\n"
+    "    for (int l = 0; l < k; l += 4) {\n"
+    "        bvec4 in_range = lessThan(ivec4(l) + ivec4(0, 1, 2, 3), ivec4(k));\n"
+    "        acc += load_a4(p * stridea, i0, l, in_range) * load_b4(p * strideb, l, j, in_range);\n"
     "    }\n"
+    "#else\n"
+    "    bvec4 live;\n"
+    "    for (int lane = 0; lane < 4; lane++) {\n"
+    "        int e = t * 4 + lane - offc;\n"
+    "        int p = e / stridec;\n"
+    "        int i = (e - p * stridec) % ldc;\n"
+    "        int j = (e - p * stridec) / ldc;\n"
+    "        live[lane] = e >= 0 && p < batch && i < m && j < n;\n"
+    "        if (live[lane]) {\n"
+    "            for (int l = 0; l < k; l++)\n"
+    "                acc[lane] += fetch(a, p * stridea + A_INDEX(i, l)) * fetch(b, p * strideb + B_INDEX(l, j));\n"
+    "        }\n"
+    "    }\n"
+    "#endif\n"
+    "    FragColor = mix(vc, gemm_result(acc, vc), live);\n"
+    "}";
+
+/*
+ * sgemv: y texel t holds rows (t*4 + l) / incy of op(a), so one invocation
+ * computes four dot products over the inner dimension k. with unit strides
+ * and lda % 4 == 0 (UNIT_STRIDE) they are vec4 loads: a texel of a column per
+ * step for op(a) = a, four column texels against one x texel for a^T.
+ * max_index spans y; the split kernels cover inner ranges of ldb elements.
+ */
+#define GLSL_GEMV \
+    "vec4 gemv_dot(int t, int l0, int l1)\n" \
+    "{\n" \
+    "    vec4 acc = vec4(0.0);\n" \
+    "#if defined(UNIT_STRIDE) && defined(A_TRANS)\n" \
+    "    for (int l = l0; l < l1; l += 4) {\n" \
+    "        bvec4 in_range = lessThan(ivec4(l) + ivec4(0, 1, 2, 3), ivec4(l1));\n" \
+    "        vec4 vx = mix(vec4(0.0), fetch4(b, l / 4), in_range);\n" \
+    "        for (int r = 0; r < 4; r++)\n" \
+    "            acc[r] += dot(mix(vec4(0.0), fetch4(a, ((t * 4 + r) * lda + l) / 4), in_range), vx);\n" \
+    "    }\n" \
+    "#elif defined(UNIT_STRIDE)\n" \
+    "    for (int l = l0; l < l1; l += 4) {\n" \
+    "        vec4 vx = fetch4(b, l / 4);\n" \
+    "        for (int j = 0; j < 4 && l + j < l1; j++)\n" \
+    "            acc += fetch4(a, (l + j) * (lda / 4) + t) * vx[j];\n" \
+    "    }\n" \
+    "#else\n" \
+    "    bvec4 live = lanes(t, incy);\n" \
+    "    for (int r = 0; r < 4; r++) {\n" \
+    "        if (!live[r]) continue;\n" \
+    "        int i = (t * 4 + r) / incy;\n" \
+    "        for (int l = l0; l < l1; l++)\n" \
+    "            acc[r] += fetch(a, A_INDEX(i, l)) * fetch(b, l * incx);\n" \
+    "    }\n" \
+    "#endif\n" \
+    "    return acc;\n" \
+    "}\n"
+
+// y = alpha*op(a)*x + beta*y, one fragment per texel of y
+static const char *const glblas_fs_src_sgemv =
+    "out vec4 FragColor;\n"
+    GLSL_PARAMS
+    GLSL_SCALARS
+    GLSL_VARIANT
+    "uniform sampler2D a;\n"
+    "uniform sampler2D b;\n"
+    "uniform sampler2D c;\n"
+    GLSL_FETCH
+    GLSL_GEMM
+    GLSL_GEMV
     "void main()\n"
     "{\n"
-    "    int index = int(gl_FragCoord.y - 0.5) * int(dims.x) + int(gl_FragCoord.x - 0.5) * 4;\n"
-    "    vec4 vy = (beta != 0.f) ? texture(c, TexCoord) : vec4(0, 0, 0, 0);\n"
-    "    vec2 aTexCoord;\n"
-    "    vec2 bTexCoord;\n"
-    "    int ax = aT ? k : int(adims.x);\n"
-    "    int ay = aT ? int(adims.x) : k;\n"
-    "    int bx = bT ? int(bdims.y) : k;\n"
-    "    int by = bT ? k : int(bdims.y);\n"
-    "    kernel(0, r);\n"
-    "    kernel(1, g);\n"
-    "    kernel(2, b);\n"
-    "    kernel(3, a);\n"
-    "    FragColor = vy;\n"
+    "    int t = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 vy = texelFetch(c, ivec2(gl_FragCoord.xy), 0);\n"
+    "    FragColor = mix(vy, gemm_result(gemv_dot(t, 0, k), vy), lanes(t, incy));\n"
     "}";
 
-static const char *const glblas_fs_src_sgemm4x4 =
-    "#version 330 core\n"
+// split sgemv, first pass: texel s*T + t holds y texel t's sums over inner range s, n ranges
+static const char *const glblas_fs_src_sgemv_partial =
     "out vec4 FragColor;\n"
-    "in vec2 TexCoord;\n"
+    GLSL_PARAMS
+    GLSL_VARIANT
     "uniform sampler2D a;\n"
     "uniform sampler2D b;\n"
+    GLSL_FETCH
+    GLSL_GEMM_INDEX
+    GLSL_GEMV
+    "void main()\n"
+    "{\n"
+    "    int p = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    int texels = (max_index + 3) / 4;\n"
+    "    int s = p / texels;\n"
+    "    FragColor = gemv_dot(p % texels, s * ldb, min(k, (s + 1) * ldb));\n"
+    "}";
+
+// split sgemv, second pass: sum the n partials of each y texel into y
+static const char *const glblas_fs_src_sgemv_sum =
+    "out vec4 FragColor;\n"
+    GLSL_PARAMS
+    GLSL_SCALARS
+    GLSL_VARIANT
+    "uniform sampler2D x;\n"
+    "uniform sampler2D c;\n"
+    GLSL_FETCH
+    GLSL_GEMM
+    "void main()\n"
+    "{\n"
+    "    int t = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    int texels = (max_index + 3) / 4;\n"
+    "    vec4 vy = texelFetch(c, ivec2(gl_FragCoord.xy), 0);\n"
+    "    vec4 acc = vec4(0.0);\n"
+    "    for (int s = 0; s < n; s++)\n"
+    "        acc += fetch4(x, s * texels + t);\n"
+    "    FragColor = mix(vy, gemm_result(acc, vy), lanes(t, incy));\n"
+    "}";
+
+/*
+ * sger: a texel of a gets alpha * x[i] * y[j] added to each of its live
+ * elements. with incx == 1 and lda % 4 == 0 (UNIT_STRIDE) the texel is four
+ * rows of one column, so the update is one x texel times one y element.
+ * max_index spans a, (N - 1) * lda + M.
+ */
+#define GLSL_GER \
+    "vec4 ger_update(int t, out bvec4 live)\n" \
+    "{\n" \
+    "    ivec4 e = ivec4(t * 4) + ivec4(0, 1, 2, 3);\n" \
+    "    ivec4 i = e % lda;\n" \
+    "    live = bvec4(ivec4(lessThan(i, ivec4(m))) & ivec4(lessThan(e, ivec4(max_index))));\n" \
+    "#ifdef UNIT_STRIDE\n" \
+    "    return fetch4(x, i.x / 4) * fetch(y, (e.x / lda) * incy);\n" \
+    "#else\n" \
+    "    vec4 v;\n" \
+    "    for (int l = 0; l < 4; l++)\n" \
+    "        v[l] = fetch(x, i[l] * incx) * fetch(y, (e[l] / lda) * incy);\n" \
+    "    return v;\n" \
+    "#endif\n" \
+    "}\n"
+
+// a = alpha*x*y^T + a
+static const char *const glblas_fs_src_sger =
+    "out vec4 FragColor;\n"
+    GLSL_PARAMS
+    GLSL_SCALARS
+    GLSL_VARIANT
+    "uniform sampler2D x;\n"
+    "uniform sampler2D y;\n"
+    "uniform sampler2D c;\n"
+    GLSL_FETCH
+    GLSL_GER
+    "void main()\n"
+    "{\n"
+    "    int t = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 va = texelFetch(c, ivec2(gl_FragCoord.xy), 0);\n"
+    "    bvec4 live;\n"
+    "    vec4 v = ger_update(t, live);\n"
+    "    FragColor = mix(va, va + SCALE_ALPHA(v), live);\n"
+    "}";
+
+/*
+ * ssyrk: c = alpha*op(a)*op(a)^T + beta*c on the uplo triangle of c only
+ * (0 lower, 1 upper), the other triangle is left as is. texels with no live
+ * element return before the dot products, which skips about half of c. with
+ * lda and ldc multiples of 4 (UNIT_STRIDE) the loads are vec4s, as in sgemv.
+ */
+static const char *const glblas_fs_src_ssyrk =
+    "out vec4 FragColor;\n"
+    GLSL_PARAMS
+    GLSL_SCALARS
+    GLSL_VARIANT
+    "uniform sampler2D a;\n"
     "uniform sampler2D c;\n"
-    "uniform int lda;\n" // M
-    "uniform int ldb;\n" // K
-    "uniform int ldc;\n" // M
-    "uniform bool aT;\n"
-    "uniform bool bT;\n"
-    "uniform float alpha;\n"
-    "uniform float beta;\n"
-    "uniform vec2 dims\n; /* .x = M, .y = N */\n"
-    "uniform vec2 adims;\n"
-    "uniform vec2 bdims;\n"
-    "uniform int m;\n"
-    "uniform int n;\n"
-    "uniform int k;\n"
-    "uniform int max_index;\n"
-    "#define kernel(offs, elem) \\\n"
-    "    if ((index + offs) < max_index) { \\\n"
-    "        float val = 0; \\\n"
-    "        int i = (index + offs) % m; \\\n" // row
-    "        int j = (index + offs) / m; \\\n" // col
-    "        for (int l = 0; l < k; l += 4) { \\\n"
-    "            int aindex = /*aT ? lda * l + i :*/ lda * i + l; \\\n" // think this is right
-    "            int bindex = /*bT ? ldb * l + j :*/ ldb * j + l; \\\n"
-    "            aTexCoord.y = float((aindex / 4) / ax) / ay; \\\n"
-    "            aTexCoord.x = float((aindex / 4) % ax) / ax; \\\n"
-    "            bTexCoord.y = float((bindex / 4) / bx) / by; \\\n"
-    "            bTexCoord.x = float((bindex / 4) % bx) / bx; \\\n"
-    "            vec4 va = texture(a, aTexCoord); \\\n"
-    "            vec4 vb = texture(b, bTexCoord); \\\n"
-    "            vb = va * vb; \\\n"
-    "            val += vb.r + vb.g + vb.b + vb.a; \\\n"
-    "        } \\\n"
-    "        vy.elem = (alpha * val) + (vy.elem * beta); \\\n"
+    GLSL_FETCH
+    GLSL_GEMM
+    "void main()\n"
+    "{\n"
+    "    int t = int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x);\n"
+    "    vec4 vc = texelFetch(c, ivec2(gl_FragCoord.xy), 0);\n"
+    "    ivec4 e = ivec4(t * 4) + ivec4(0, 1, 2, 3);\n"
+    "    ivec4 i = e % ldc;\n"
+    "    ivec4 j = e / ldc;\n"
+    "    bvec4 tri = uplo != 0 ? lessThanEqual(i, j) : greaterThanEqual(i, j);\n"
+    "    bvec4 live = bvec4(ivec4(lessThan(max(i, j), ivec4(n))) & ivec4(tri));\n"
+    "    if (!any(live)) {\n"
+    "        FragColor = vc;\n"
+    "        return;\n"
     "    }\n"
+    "    vec4 acc = vec4(0.0);\n"
+    "#if defined(UNIT_STRIDE) && defined(A_TRANS)\n"
+    "    for (int l = 0; l < k; l += 4) {\n"
+    "        bvec4 in_range = lessThan(ivec4(l) + ivec4(0, 1, 2, 3), ivec4(k));\n"
+    "        vec4 vj = mix(vec4(0.0), fetch4(a, (j.x * lda + l) / 4), in_range);\n"
+    "        for (int r = 0; r < 4; r++)\n"
+    "            acc[r] += dot(mix(vec4(0.0), fetch4(a, (i[r] * lda + l) / 4), in_range), vj);\n"
+    "    }\n"
+    "#elif defined(UNIT_STRIDE)\n"
+    "    for (int l = 0; l < k; l++)\n"
+    "        acc += fetch4(a, (l * lda + i.x) / 4) * fetch(a, l * lda + j.x);\n"
+    "#else\n"
+    "    for (int lane = 0; lane < 4; lane++) {\n"
+    "        if (!live[lane]) continue;\n"
+    "        for (int l = 0; l < k; l++)\n"
+    "            acc[lane] += fetch(a, A_INDEX(i[lane], l)) * fetch(a, A_INDEX(j[lane], l));\n"
+    "    }\n"
+    "#endif\n"
+    "    FragColor = mix(vc, gemm_result(acc, vc), live);\n"
+    "}";
+
+/*
+ * strsm diagonal blocks: the inverse of each NB by NB diagonal block of op(a),
+ * blocks stored one after another with ld NB, so a texel is rows i0..i0+3 of
+ * one column j. column j is op(a) solved against e_j by substitution from j
+ * (uplo 1: op(a) upper, going up), which makes columns independent. the
+ * compute kernel solves a whole column per invocation, O(NB^2) each; a
+ * fragment only writes its texel, so it runs the substitution from j to its
+ * far row once and keeps the 4 rows it owns, O((i0 - j)^2) per texel. m is the
+ * order of a, the last block may be partial.
+ */
+#define TRSM_BLOCK 64
+
+#define GLSL_TRSM \
+    "const int NB = 64;\n" /* TRSM_BLOCK */ \
+    "float tri(int i, int l)\n" \
+    "{\n" \
+    "    return fetch(a, A_INDEX(i, l));\n" \
+    "}\n"
+
+static const char *const glblas_fs_src_strsm =
+    "out vec4 FragColor;\n"
+    GLSL_PARAMS
+    "uniform sampler2D a;\n"
+    GLSL_FETCH
+    GLSL_GEMM_INDEX
+    GLSL_TRSM
     "void main()\n"
     "{\n"
-    "    int index = int(gl_FragCoord.y - 0.5) * int(dims.x) + int(gl_FragCoord.x - 0.5) * 4;\n"
-    "    vec4 vy = (beta != 0.f) ? texture(c, TexCoord) : vec4(0, 0, 0, 0);\n"
-    "    vec2 aTexCoord;\n"
-    "    vec2 bTexCoord;\n"
-    "    int ax = aT ? k : int(adims.x);\n"
-    "    int ay = aT ? int(adims.x) : k;\n"
-    "    int bx = bT ? int(bdims.y) : k;\n"
-    "    int by = bT ? k : int(bdims.y);\n"
-    "    kernel(0, r);\n"
-    "    kernel(1, g);\n"
-    "    kernel(2, b);\n"
-    "    kernel(3, a);\n"
-    "    FragColor = vy;\n"
+    "    int e0 = (int(gl_FragCoord.y) * int(dims.x) + int(gl_FragCoord.x)) * 4;\n"
+    "    int k0 = e0 / (NB * NB) * NB;\n"
+    "    int i0 = e0 % NB;\n"
+    "    int j = e0 / NB % NB;\n"
+    "    int nb = min(NB, m - k0);\n"
+    "    int d = uplo != 0 ? -1 : 1;\n"
+    "    int last = uplo != 0 ? i0 : min(i0 + 3, nb - 1);\n"
+    "    vec4 r = vec4(0.0);\n"
+    "    if (e0 < max_index && j < nb && (uplo != 0 ? i0 <= j : i0 + 3 >= j)) {\n"
+    "        float ys[NB];\n"
+    "        for (int v = j; v != last + d; v += d) {\n"
+    "            float s = v == j ? 1.0 : 0.0;\n"
+    "            for (int l = j; l != v; l += d)\n"
+    "                s -= tri(k0 + v, k0 + l) * ys[l];\n"
+    "            ys[v] = diag != 0 ? s : s / tri(k0 + v, k0 + v);\n"
+    "            if (v >= i0 && v < i0 + 4)\n"
+    "                r[v - i0] = ys[v];\n"
+    "        }\n"
+    "    }\n"
+    "    FragColor = r;\n"
     "}";
 
-static const char *const glblas_fs_src_sgemm4x4_reorder =
-    "#version 330 core\n"
+// y[offy + i] = x[offx + i] for i < max_index, used for copies that don't start or end on a texel
+static const char *const glblas_fs_src_memcpy =
     "out vec4 FragColor;\n"
     "in vec2 TexCoord;\n"
+    GLSL_PARAMS
     "uniform sampler2D x;\n"
     "uniform sampler2D y;\n"
-    "uniform vec2 dims;\n"
-    "uniform int max_index;\n"
-    "#define kernel(offs, elem) \\\n"
-    "    if ((index + offs) < max_index) { \\\n"
-    "        int xindex = (fragm + ((max_index / 4) * offs)) /4; \\\n"
-    "        xTexCoord.y = float((xindex) / int(dims.x)) / dims.y; \\\n"
-    "        xTexCoord.x = float((xindex) % int(dims.x)) / dims.x; \\\n"
-    "        vec4 vx = texture(x, xTexCoord); \\\n"
-    "        float val; \\\n"
-    "        switch (fragm % 4) { \\\n"
-    "        case 0: val = vx.r; break; \\\n"
-    "        case 1: val = vx.g; break; \\\n"
-    "        case 2: val = vx.b; break; \\\n"
-    "        case 3: val = vx.a; break; \\\n"
-    "        } \\\n"
-    "        vy.elem = val; \\\n"
-    "    }\n"
     "void main()\n"
     "{\n"
-    "    int index = int(gl_FragCoord.y - 0.5) * int(dims.x) + int(gl_FragCoord.x - 0.5) * 4;\n"
-    "    int fragm = index / 4;\n"
-    "    vec4 vy = vec4(0, 0, 0, 0);\n"
-    "    vec2 xTexCoord;\n"
-    "    kernel(0, r);\n"
-    "    kernel(1, g);\n"
-    "    kernel(2, b);\n"
-    "    kernel(3, a);\n"
+    "    ivec2 coord = ivec2(gl_FragCoord.xy);\n"
+    "    int index = (coord.y * int(dims.x) + coord.x) * 4 - offy;\n"
+    "    int xwidth = int(adims.x);\n"
+    "    vec4 vy = texelFetch(y, coord, 0);\n"
+    "    for (int l = 0; l < 4; l++) {\n"
+    "        if (index + l >= 0 && index + l < max_index) {\n"
+    "            int xindex = offx + index + l;\n"
+    "            vy[l] = texelFetch(x, ivec2((xindex / 4) % xwidth, (xindex / 4) / xwidth), 0)[xindex % 4];\n"
+    "        }\n"
+    "    }\n"
     "    FragColor = vy;\n"
     "}";
 
-_glblas_internal_shader shaders[OP_MAX] = {
-    [OP_GENERIC]    = { .src = glblas_vs_src_generic },
-
-    [OP_SSCAL]      = { .src = glblas_fs_src_sscal },
-    [OP_SCOPY]      = { .src = glblas_fs_src_scopyv2 },
-    [OP_SAXPY]      = { .src = glblas_fs_src_saxpyv2 },
-    [OP_SDOT]       = { .src = glblas_fs_src_sdot },
-    [OP_SDOTV2_MUL] = { .src = glblas_fs_src_sdotv3_mul },
-    [OP_SDOTV2_SUM] = { .src = glblas_fs_src_sdotv2_sum },
-    [OP_SASUM]      = { .src = glblas_fs_src_sasum },
-    [OP_SGEMM]      = { .src = glblas_fs_src_sgemm },
-    [OP_SGEMM4x4]   = { .src = glblas_fs_src_sgemm4x4 },
-    [OP_SGEMM4x4_R] = { .src = glblas_fs_src_sgemm4x4_reorder }
+/*
+ * compute backend (GL 4.3+): buffers keep their RGBA32F textures, kernels read
+ * inputs through the same samplers and texelFetch as the fragment reductions
+ * and write their output texels through an image unit. every invocation owns
+ * whole output texels, so there are no lane races between invocations.
+ * 1d dispatches are folded into a 2d grid to stay under 65535 groups per axis.
+ */
+#define CS_GROUP_SIZE 256
+#define CS_MAX_GROUPS 65535
+
+#define GLSL_CS_COMMON \
+    "layout(rgba32f, binding = 0) uniform image2D dst;\n" \
+    "int group_index()\n" \
+    "{\n" \
+    "    return int(gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x);\n" \
+    "}\n" \
+    "ivec2 dst_coord(int t)\n" \
+    "{\n" \
+    "    int w = imageSize(dst).x;\n" \
+    "    return ivec2(t % w, t / w);\n" \
+    "}\n"
+
+// 256 wide tree sum in shared memory, every invocation gets the total
+#define GLSL_CS_SUM \
+    "shared float partial[256];\n" \
+    "float workgroup_sum(float v)\n" \
+    "{\n" \
+    "    int lid = int(gl_LocalInvocationID.x);\n" \
+    "    partial[lid] = v;\n" \
+    "    for (int s = 128; s > 0; s >>= 1) {\n" \
+    "        barrier();\n" \
+    "        if (lid < s)\n" \
+    "            partial[lid] += partial[lid + s];\n" \
+    "    }\n" \
+    "    barrier();\n" \
+    "    return partial[0];\n" \
+    "}\n"
+
+static const char *const glblas_cs_src_sscal =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    GLSL_SCALARS
+    GLSL_VARIANT
+    GLSL_CS_COMMON
+    "void main()\n"
+    "{\n"
+    "    int t = group_index() * 256 + int(gl_LocalInvocationID.x);\n"
+    "    if (t * 4 >= max_index) return;\n"
+    "    ivec2 c = dst_coord(t);\n"
+    "    vec4 v = imageLoad(dst, c);\n"
+    "    imageStore(dst, c, mix(v, v * load_alpha(), lanes(t, incx)));\n"
+    "}";
+
+static const char *const glblas_cs_src_scopy =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    GLSL_VARIANT
+    "uniform sampler2D x;\n"
+    GLSL_FETCH
+    GLSL_CS_COMMON
+    "void main()\n"
+    "{\n"
+    "    int t = group_index() * 256 + int(gl_LocalInvocationID.x);\n"
+    "    if (t * 4 >= max_index) return;\n"
+    "    ivec2 c = dst_coord(t);\n"
+    "    vec4 v = imageLoad(dst, c);\n"
+    "#ifdef UNIT_STRIDE\n"
+    "    vec4 vx = fetch4(x, t);\n"
+    "#else\n"
+    "    vec4 vx;\n"
+    "    for (int l = 0; l < 4; l++)\n"
+    "        vx[l] = fetch(x, ((t * 4 + l) / incy) * incx);\n"
+    "#endif\n"
+    "    imageStore(dst, c, mix(v, vx, lanes(t, incy)));\n"
+    "}";
+
+static const char *const glblas_cs_src_saxpy =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    GLSL_SCALARS
+    GLSL_VARIANT
+    "uniform sampler2D x;\n"
+    GLSL_FETCH
+    GLSL_CS_COMMON
+    "void main()\n"
+    "{\n"
+    "    int t = group_index() * 256 + int(gl_LocalInvocationID.x);\n"
+    "    if (t * 4 >= max_index) return;\n"
+    "    ivec2 c = dst_coord(t);\n"
+    "    vec4 v = imageLoad(dst, c);\n"
+    "#ifdef UNIT_STRIDE\n"
+    "    vec4 vx = fetch4(x, t);\n"
+    "#else\n"
+    "    vec4 vx;\n"
+    "    for (int l = 0; l < 4; l++)\n"
+    "        vx[l] = fetch(x, ((t * 4 + l) / incy) * incx);\n"
+    "#endif\n"
+    "    imageStore(dst, c, mix(v, v + SCALE_ALPHA(vx), lanes(t, incy)));\n"
+    "}";
+
+// first pass of sdot: one partial sum per 4096 elements (16 per invocation)
+static const char *const glblas_cs_src_sdot =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    "uniform sampler2D x;\n"
+    "uniform sampler2D y;\n"
+    GLSL_FETCH
+    GLSL_CS_COMMON
+    GLSL_CS_SUM
+    "void main()\n"
+    "{\n"
+    "    int g = group_index();\n"
+    "    int lid = int(gl_LocalInvocationID.x);\n"
+    "    float acc = 0.0;\n"
+    "#ifdef UNIT_STRIDE\n"
+    "    for (int j = 0; j < 4; j++) {\n"
+    "        int t = (g * 4 + j) * 256 + lid;\n"
+    "        bvec4 live = lessThan(ivec4(t * 4) + ivec4(0, 1, 2, 3), ivec4(max_index));\n"
+    "        if (live.x)\n"
+    "            acc += dot(mix(vec4(0.0), fetch4(x, t) * fetch4(y, t), live), vec4(1.0));\n"
+    "    }\n"
+    "#else\n"
+    "    for (int j = 0; j < 16; j++) {\n"
+    "        int e = (g * 16 + j) * 256 + lid;\n"
+    "        if (e * incy < max_index)\n"
+    "            acc += fetch(x, e * incx) * fetch(y, e * incy);\n"
+    "    }\n"
+    "#endif\n"
+    "    float sum = workgroup_sum(acc);\n"
+    "    if (lid == 0)\n"
+    "        imageStore(dst, dst_coord(g), vec4(sum, 0.0, 0.0, 0.0));\n"
+    "}";
+
+// first pass of sasum, same shape as sdot
+static const char *const glblas_cs_src_sasum =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    "uniform sampler2D x;\n"
+    GLSL_FETCH
+    GLSL_CS_COMMON
+    GLSL_CS_SUM
+    "void main()\n"
+    "{\n"
+    "    int g = group_index();\n"
+    "    int lid = int(gl_LocalInvocationID.x);\n"
+    "    float acc = 0.0;\n"
+    "#ifdef UNIT_STRIDE\n"
+    "    for (int j = 0; j < 4; j++) {\n"
+    "        int t = (g * 4 + j) * 256 + lid;\n"
+    "        bvec4 live = lessThan(ivec4(t * 4) + ivec4(0, 1, 2, 3), ivec4(max_index));\n"
+    "        if (live.x)\n"
+    "            acc += dot(mix(vec4(0.0), abs(fetch4(x, t)), live), vec4(1.0));\n"
+    "    }\n"
+    "#else\n"
+    "    for (int j = 0; j < 16; j++) {\n"
+    "        int e = (g * 16 + j) * 256 + lid;\n"
+    "        if (e * incx < max_index)\n"
+    "            acc += abs(fetch(x, e * incx));\n"
+    "    }\n"
+    "#endif\n"
+    "    float sum = workgroup_sum(acc);\n"
+    "    if (lid == 0)\n"
+    "        imageStore(dst, dst_coord(g), vec4(sum, 0.0, 0.0, 0.0));\n"
+    "}";
+
+// the same tree over whole texels, for sums that keep separate lanes
+#define GLSL_CS_SUM4 \
+    "shared vec4 partial4[256];\n" \
+    "vec4 workgroup_sum4(vec4 v)\n" \
+    "{\n" \
+    "    int lid = int(gl_LocalInvocationID.x);\n" \
+    "    partial4[lid] = v;\n" \
+    "    for (int s = 128; s > 0; s >>= 1) {\n" \
+    "        barrier();\n" \
+    "        if (lid < s)\n" \
+    "            partial4[lid] += partial4[lid + s];\n" \
+    "    }\n" \
+    "    barrier();\n" \
+    "    return partial4[0];\n" \
+    "}\n"
+
+// first pass of snrm2: per group sums, lane by lane as in the fragment kernel
+static const char *const glblas_cs_src_snrm2 =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    "uniform sampler2D x;\n"
+    GLSL_FETCH
+    GLSL_NRM2
+    GLSL_CS_COMMON
+    GLSL_CS_SUM4
+    "void main()\n"
+    "{\n"
+    "    int g = group_index();\n"
+    "    int lid = int(gl_LocalInvocationID.x);\n"
+    "    vec4 acc = vec4(0.0);\n"
+    "#ifdef UNIT_STRIDE\n"
+    "    for (int j = 0; j < 4; j++) {\n"
+    "        int t = (g * 4 + j) * 256 + lid;\n"
+    "        bvec4 live = lessThan(ivec4(t * 4) + ivec4(0, 1, 2, 3), ivec4(max_index));\n"
+    "        if (live.x)\n"
+    "            acc += nrm2_sums(mix(vec4(0.0), fetch4(x, t), live));\n"
+    "    }\n"
+    "#else\n"
+    "    for (int j = 0; j < 16; j++) {\n"
+    "        int e = (g * 16 + j) * 256 + lid;\n"
+    "        if (e * incx < max_index)\n"
+    "            acc += nrm2_sums(vec4(fetch(x, e * incx), 0.0, 0.0, 0.0));\n"
+    "    }\n"
+    "#endif\n"
+    "    vec4 sum = workgroup_sum4(acc);\n"
+    "    if (lid == 0)\n"
+    "        imageStore(dst, dst_coord(g), sum);\n"
+    "}";
+
+// later passes: each group sums 1024 texels of the previous level lane by lane, max_index texels in total
+#define GLSL_CS_REDUCE_LOAD \
+    "    int g = group_index();\n" \
+    "    int lid = int(gl_LocalInvocationID.x);\n" \
+    "    vec4 acc = vec4(0.0);\n" \
+    "    for (int j = 0; j < 4; j++) {\n" \
+    "        int t = (g * 4 + j) * 256 + lid;\n" \
+    "        if (t < max_index)\n" \
+    "            acc += fetch4(x, t);\n" \
+    "    }\n" \
+    "    vec4 sum = workgroup_sum4(acc);\n"
+
+static const char *const glblas_cs_src_reduce =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    "uniform sampler2D x;\n"
+    GLSL_FETCH
+    GLSL_CS_COMMON
+    GLSL_CS_SUM4
+    "void main()\n"
+    "{\n"
+    GLSL_CS_REDUCE_LOAD
+    "    if (lid == 0)\n"
+    "        imageStore(dst, dst_coord(g), sum);\n"
+    "}";
+
+// last pass, a single group: only the first float of the result is written
+static const char *const glblas_cs_src_reduce_final =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    "uniform sampler2D x;\n"
+    GLSL_FETCH
+    GLSL_CS_COMMON
+    GLSL_CS_SUM4
+    "void main()\n"
+    "{\n"
+    GLSL_CS_REDUCE_LOAD
+    "    if (lid == 0) {\n"
+    "        vec4 v = imageLoad(dst, ivec2(0, 0));\n"
+    "        v.x = dot(sum, vec4(1.0));\n"
+    "        imageStore(dst, ivec2(0, 0), v);\n"
+    "    }\n"
+    "}";
+
+static const char *const glblas_cs_src_snrm2_final =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    "uniform sampler2D x;\n"
+    GLSL_FETCH
+    GLSL_NRM2
+    GLSL_CS_COMMON
+    GLSL_CS_SUM4
+    "void main()\n"
+    "{\n"
+    GLSL_CS_REDUCE_LOAD
+    "    if (lid == 0) {\n"
+    "        vec4 v = imageLoad(dst, ivec2(0, 0));\n"
+    "        v.x = nrm2(sum);\n"
+    "        imageStore(dst, ivec2(0, 0), v);\n"
+    "    }\n"
+    "}";
+
+// 256 wide tree of pick() in shared memory, every invocation gets the winner
+#define GLSL_CS_PICK \
+    "shared vec4 best[256];\n" \
+    "vec4 workgroup_pick(vec4 v)\n" \
+    "{\n" \
+    "    int lid = int(gl_LocalInvocationID.x);\n" \
+    "    best[lid] = v;\n" \
+    "    for (int s = 128; s > 0; s >>= 1) {\n" \
+    "        barrier();\n" \
+    "        if (lid < s)\n" \
+    "            best[lid] = pick(best[lid], best[lid + s]);\n" \
+    "    }\n" \
+    "    barrier();\n" \
+    "    return best[0];\n" \
+    "}\n"
+
+// srot with x on image unit 0 and y on unit 1, layouts may differ
+static const char *const glblas_cs_src_srot =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    GLSL_VARIANT
+    GLSL_CS_COMMON
+    "layout(rgba32f, binding = 1) uniform image2D dst_y;\n"
+    "void main()\n"
+    "{\n"
+    "    int t = group_index() * 256 + int(gl_LocalInvocationID.x);\n"
+    "    if (t * 4 >= max_index) return;\n"
+    "    int w = imageSize(dst_y).x;\n"
+    "    ivec2 cx = dst_coord(t);\n"
+    "    ivec2 cy = ivec2(t % w, t / w);\n"
+    "    vec4 vx = imageLoad(dst, cx);\n"
+    "    vec4 vy = imageLoad(dst_y, cy);\n"
+    "    bvec4 live = lanes(t, incx);\n"
+    "    imageStore(dst, cx, mix(vx, rot.x * vx + rot.z * vy, live));\n"
+    "    imageStore(dst_y, cy, mix(vy, rot.y * vx + rot.w * vy, live));\n"
+    "}";
+
+static const char *const glblas_cs_src_sswap =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    GLSL_VARIANT
+    GLSL_CS_COMMON
+    "layout(rgba32f, binding = 1) uniform image2D dst_y;\n"
+    "void main()\n"
+    "{\n"
+    "    int t = group_index() * 256 + int(gl_LocalInvocationID.x);\n"
+    "    if (t * 4 >= max_index) return;\n"
+    "    int w = imageSize(dst_y).x;\n"
+    "    ivec2 cx = dst_coord(t);\n"
+    "    ivec2 cy = ivec2(t % w, t / w);\n"
+    "    vec4 vx = imageLoad(dst, cx);\n"
+    "    vec4 vy = imageLoad(dst_y, cy);\n"
+    "    bvec4 live = lanes(t, incx);\n"
+    "    imageStore(dst, cx, mix(vx, vy, live));\n"
+    "    imageStore(dst_y, cy, mix(vy, vx, live));\n"
+    "}";
+
+// sgemv kernels, one invocation per output texel as in the fragment versions
+static const char *const glblas_cs_src_sgemv =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    GLSL_SCALARS
+    GLSL_VARIANT
+    "uniform sampler2D a;\n"
+    "uniform sampler2D b;\n"
+    GLSL_FETCH
+    GLSL_GEMM
+    GLSL_GEMV
+    GLSL_CS_COMMON
+    "void main()\n"
+    "{\n"
+    "    int t = group_index() * 256 + int(gl_LocalInvocationID.x);\n"
+    "    if (t * 4 >= max_index) return;\n"
+    "    ivec2 c = dst_coord(t);\n"
+    "    vec4 vy = imageLoad(dst, c);\n"
+    "    imageStore(dst, c, mix(vy, gemm_result(gemv_dot(t, 0, k), vy), lanes(t, incy)));\n"
+    "}";
+
+static const char *const glblas_cs_src_sgemv_partial =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    GLSL_VARIANT
+    "uniform sampler2D a;\n"
+    "uniform sampler2D b;\n"
+    GLSL_FETCH
+    GLSL_GEMM_INDEX
+    GLSL_GEMV
+    GLSL_CS_COMMON
+    "void main()\n"
+    "{\n"
+    "    int p = group_index() * 256 + int(gl_LocalInvocationID.x);\n"
+    "    int texels = (max_index + 3) / 4;\n"
+    "    if (p >= texels * n) return;\n"
+    "    int s = p / texels;\n"
+    "    imageStore(dst, dst_coord(p), gemv_dot(p % texels, s * ldb, min(k, (s + 1) * ldb)));\n"
+    "}";
+
+static const char *const glblas_cs_src_sgemv_sum =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    GLSL_SCALARS
+    GLSL_VARIANT
+    "uniform sampler2D x;\n"
+    GLSL_FETCH
+    GLSL_GEMM
+    GLSL_CS_COMMON
+    "void main()\n"
+    "{\n"
+    "    int t = group_index() * 256 + int(gl_LocalInvocationID.x);\n"
+    "    int texels = (max_index + 3) / 4;\n"
+    "    if (t >= texels) return;\n"
+    "    ivec2 c = dst_coord(t);\n"
+    "    vec4 vy = imageLoad(dst, c);\n"
+    "    vec4 acc = vec4(0.0);\n"
+    "    for (int s = 0; s < n; s++)\n"
+    "        acc += fetch4(x, s * texels + t);\n"
+    "    imageStore(dst, c, mix(vy, gemm_result(acc, vy), lanes(t, incy)));\n"
+    "}";
+
+// first pass of isamax: one candidate per 4096 elements, same shape as sdot
+static const char *const glblas_cs_src_isamax =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    "uniform sampler2D x;\n"
+    GLSL_FETCH
+    GLSL_IAMAX
+    GLSL_CS_COMMON
+    GLSL_CS_PICK
+    "void main()\n"
+    "{\n"
+    "    int g = group_index();\n"
+    "    int lid = int(gl_LocalInvocationID.x);\n"
+    "    vec4 acc = none;\n"
+    "#ifdef UNIT_STRIDE\n"
+    "    for (int j = 0; j < 4; j++) {\n"
+    "        int t = (g * 4 + j) * 256 + lid;\n"
+    "        if (t * 4 >= max_index) break;\n"
+    "        vec4 v = fetch4(x, t);\n"
+    "        for (int l = 0; l < 4 && t * 4 + l < max_index; l++)\n"
+    "            acc = pick(acc, candidate(v[l], t * 4 + l));\n"
+    "    }\n"
+    "#else\n"
+    "    for (int j = 0; j < 16; j++) {\n"
+    "        int e = (g * 16 + j) * 256 + lid;\n"
+    "        if (e * incx >= max_index) break;\n"
+    "        acc = pick(acc, candidate(fetch(x, e * incx), e));\n"
+    "    }\n"
+    "#endif\n"
+    "    vec4 winner = workgroup_pick(acc);\n"
+    "    if (lid == 0)\n"
+    "        imageStore(dst, dst_coord(g), winner);\n"
+    "}";
+
+// later passes: each group picks from 1024 candidate texels, max_index in total
+static const char *const glblas_cs_src_isamax_reduce =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    "uniform sampler2D x;\n"
+    GLSL_FETCH
+    GLSL_IAMAX
+    GLSL_CS_COMMON
+    GLSL_CS_PICK
+    "void main()\n"
+    "{\n"
+    "    int g = group_index();\n"
+    "    int lid = int(gl_LocalInvocationID.x);\n"
+    "    vec4 acc = none;\n"
+    "    for (int j = 0; j < 4; j++) {\n"
+    "        int t = (g * 4 + j) * 256 + lid;\n"
+    "        if (t < max_index)\n"
+    "            acc = pick(acc, fetch4(x, t));\n"
+    "    }\n"
+    "    vec4 winner = workgroup_pick(acc);\n"
+    "    if (lid == 0)\n"
+    "        imageStore(dst, dst_coord(g), winner);\n"
+    "}";
+
+// device pointer mode, a single invocation: only the first float of the result is written
+static const char *const glblas_cs_src_isamax_final =
+    "layout(local_size_x = 1) in;\n"
+    GLSL_PARAMS
+    "uniform sampler2D x;\n"
+    GLSL_CS_COMMON
+    "void main()\n"
+    "{\n"
+    "    vec4 best = texelFetch(x, ivec2(0, 0), 0);\n"
+    "    vec4 v = imageLoad(dst, ivec2(0, 0));\n"
+    "    v.x = best.y < 0.0 ? 0.0 : float(int(best.y) * 4096 + int(best.z) + 1);\n"
+    "    imageStore(dst, ivec2(0, 0), v);\n"
+    "}";
+
+/*
+ * tiled sgemm: one 64x64 tile of c per workgroup, problem gl_WorkGroupID.z of
+ * a batch, shared by sgemm and ssyrk. each of the 16x16 invocations keeps a
+ * 4x4 block of c in registers: rows ly*4..ly*4+3 (one texel, which needs
+ * ldc % 4 == 0) of columns lx + 16*c, fed per l by one vec4 of a and four
+ * floats of b from shared memory. the k loop stages a 64x16 tile of op(a) and
+ * a 16x64 tile of op(b), so every fetched element is reused 64 times. with
+ * SYRK defined b is a itself (op(b) = op(a)^T), tiles outside the uplo
+ * triangle return before loading anything and the store is masked to the
+ * triangle.
+ */
+#define CS_SGEMM_TILE_M 64
+#define CS_SGEMM_TILE_N 64
+
+#define GLSL_CS_GEMM_TILE \
+    GLSL_CS_COMMON \
+    "shared float As[64][17];\n" \
+    "shared float Bs[16][65];\n" \
+    "float load_a(int base, int i, int l)\n" \
+    "{\n" \
+    "    return i < m && l < k ? fetch(a, base + A_INDEX(i, l)) : 0.0;\n" \
+    "}\n" \
+    "float load_b(int base, int l, int j)\n" \
+    "{\n" \
+    "#ifdef SYRK\n" \
+    "    return l < k && j < n ? fetch(a, base + A_INDEX(j, l)) : 0.0;\n" \
+    "#else\n" \
+    "    return l < k && j < n ? fetch(b, base + B_INDEX(l, j)) : 0.0;\n" \
+    "#endif\n" \
+    "}\n" \
+    "void main()\n" \
+    "{\n" \
+    "    int lx = int(gl_LocalInvocationID.x);\n" \
+    "    int ly = int(gl_LocalInvocationID.y);\n" \
+    "    int lid = ly * 16 + lx;\n" \
+    "    int row0 = int(gl_WorkGroupID.y) * 64;\n" \
+    "    int col0 = int(gl_WorkGroupID.x) * 64;\n" \
+    "#ifdef SYRK\n" \
+    "    if (uplo != 0 ? row0 > col0 + 63 : row0 + 63 < col0) return;\n" \
+    "#endif\n" \
+    "    int p = int(gl_WorkGroupID.z);\n" \
+    "    int i0 = row0 + ly * 4;\n" \
+    "    vec4 acc[4] = vec4[4](vec4(0.0), vec4(0.0), vec4(0.0), vec4(0.0));\n" \
+    "    for (int l0 = 0; l0 < k; l0 += 16) {\n" \
+    "        for (int r = 0; r < 4; r++) {\n" \
+    "            int e = lid + r * 256;\n" \
+    "            As[e / 16][e % 16] = load_a(p * stridea, row0 + e / 16, l0 + e % 16);\n" \
+    "            Bs[e / 64][e % 64] = load_b(p * strideb, l0 + e / 64, col0 + e % 64);\n" \
+    "        }\n" \
+    "        barrier();\n" \
+    "        for (int l = 0; l < 16; l++) {\n" \
+    "            vec4 va = vec4(As[ly * 4][l], As[ly * 4 + 1][l], As[ly * 4 + 2][l], As[ly * 4 + 3][l]);\n" \
+    "            for (int c = 0; c < 4; c++)\n" \
+    "                acc[c] += va * Bs[l][lx + 16 * c];\n" \
+    "        }\n" \
+    "        barrier();\n" \
+    "    }\n" \
+    "    if (i0 >= m) return;\n" \
+    "    ivec4 i = ivec4(i0) + ivec4(0, 1, 2, 3);\n" \
+    "    for (int c = 0; c < 4; c++) {\n" \
+    "        int j = col0 + lx + 16 * c;\n" \
+    "        if (j >= n) break;\n" \
+    "        ivec2 coord = dst_coord((offc + p * stridec + j * ldc + i0) / 4);\n" \
+    "        vec4 old = imageLoad(dst, coord);\n" \
+    "        bvec4 live = lessThan(i, ivec4(m));\n" \
+    "#ifdef SYRK\n" \
+    "        live = bvec4(ivec4(live) & ivec4(uplo != 0 ? lessThanEqual(i, ivec4(j)) : greaterThanEqual(i, ivec4(j))));\n" \
+    "#endif\n" \
+    "        imageStore(dst, coord, mix(old, gemm_result(acc[c], old), live));\n" \
+    "    }\n" \
+    "}\n"
+
+static const char *const glblas_cs_src_sgemm =
+    "layout(local_size_x = 16, local_size_y = 16) in;\n"
+    GLSL_PARAMS
+    GLSL_SCALARS
+    GLSL_VARIANT
+    "uniform sampler2D a;\n"
+    "uniform sampler2D b;\n"
+    GLSL_FETCH
+    GLSL_GEMM
+    GLSL_CS_GEMM_TILE;
+
+static const char *const glblas_cs_src_ssyrk =
+    "#define SYRK\n"
+    "layout(local_size_x = 16, local_size_y = 16) in;\n"
+    GLSL_PARAMS
+    GLSL_SCALARS
+    GLSL_VARIANT
+    "uniform sampler2D a;\n"
+    GLSL_FETCH
+    GLSL_GEMM
+    GLSL_CS_GEMM_TILE;
+
+// strsm diagonal blocks, one workgroup per block and one column of its inverse per invocation
+static const char *const glblas_cs_src_strsm =
+    "layout(local_size_x = 64) in;\n" /* TRSM_BLOCK */
+    GLSL_PARAMS
+    "uniform sampler2D a;\n"
+    GLSL_FETCH
+    GLSL_GEMM_INDEX
+    GLSL_TRSM
+    GLSL_CS_COMMON
+    "shared float ys[NB][NB];\n" /* ys[v][j], each invocation only touches its own column */
+    "void main()\n"
+    "{\n"
+    "    int k0 = group_index() * NB;\n"
+    "    if (k0 >= m) return;\n"
+    "    int j = int(gl_LocalInvocationID.x);\n"
+    "    int nb = min(NB, m - k0);\n"
+    "    int d = uplo != 0 ? -1 : 1;\n"
+    "    for (int v = 0; v < NB; v++)\n"
+    "        ys[v][j] = 0.0;\n"
+    "    if (j < nb) {\n"
+    "        for (int v = j; v != (uplo != 0 ? -1 : nb); v += d) {\n"
+    "            float s = v == j ? 1.0 : 0.0;\n"
+    "            for (int l = j; l != v; l += d)\n"
+    "                s -= tri(k0 + v, k0 + l) * ys[l][j];\n"
+    "            ys[v][j] = diag != 0 ? s : s / tri(k0 + v, k0 + v);\n"
+    "        }\n"
+    "    }\n"
+    "    for (int r = 0; r < NB; r += 4)\n"
+    "        imageStore(dst, dst_coord((k0 + j) * NB / 4 + r / 4), vec4(ys[r][j], ys[r + 1][j], ys[r + 2][j], ys[r + 3][j]));\n"
+    "}";
+
+// sger, one invocation per texel of a
+static const char *const glblas_cs_src_sger =
+    "layout(local_size_x = 256) in;\n"
+    GLSL_PARAMS
+    GLSL_SCALARS
+    GLSL_VARIANT
+    "uniform sampler2D x;\n"
+    "uniform sampler2D y;\n"
+    GLSL_FETCH
+    GLSL_GER
+    GLSL_CS_COMMON
+    "void main()\n"
+    "{\n"
+    "    int t = group_index() * 256 + int(gl_LocalInvocationID.x);\n"
+    "    if (t * 4 >= max_index) return;\n"
+    "    ivec2 c = dst_coord(t);\n"
+    "    vec4 va = imageLoad(dst, c);\n"
+    "    bvec4 live;\n"
+    "    vec4 v = ger_update(t, live);\n"
+    "    imageStore(dst, c, mix(va, va + SCALE_ALPHA(v), live));\n"
+    "}";
+
+static const char *const shader_sources[OP_MAX] = {
+    [OP_GENERIC]      = glblas_vs_src_generic,
+
+    [OP_SSCAL]        = glblas_fs_src_sscal,
+    [OP_SCOPY]        = glblas_fs_src_scopy,
+    [OP_SAXPY]        = glblas_fs_src_saxpy,
+    [OP_SDOT]         = glblas_fs_src_sdot,
+    [OP_SASUM]        = glblas_fs_src_sasum,
+    [OP_REDUCE]       = glblas_fs_src_reduce,
+    [OP_REDUCE_FINAL] = glblas_fs_src_reduce_final,
+    [OP_SGEMM]        = glblas_fs_src_sgemm,
+    [OP_MEMCPY]       = glblas_fs_src_memcpy,
+    [OP_ISAMAX]        = glblas_fs_src_isamax,
+    [OP_ISAMAX_REDUCE] = glblas_fs_src_isamax_reduce,
+    [OP_ISAMAX_FINAL]  = glblas_fs_src_isamax_final,
+    [OP_SNRM2]         = glblas_fs_src_snrm2,
+    [OP_SNRM2_FINAL]   = glblas_fs_src_snrm2_final,
+    [OP_SROT]          = glblas_fs_src_srot,
+    [OP_SSWAP]         = glblas_fs_src_sswap,
+    [OP_SGEMV]         = glblas_fs_src_sgemv,
+    [OP_SGEMV_PARTIAL] = glblas_fs_src_sgemv_partial,
+    [OP_SGEMV_SUM]     = glblas_fs_src_sgemv_sum,
+    [OP_SGER]          = glblas_fs_src_sger,
+    [OP_SSYRK]         = glblas_fs_src_ssyrk,
+    [OP_STRSM]         = glblas_fs_src_strsm,
+
+    [OP_CS_SSCAL]        = glblas_cs_src_sscal,
+    [OP_CS_SCOPY]        = glblas_cs_src_scopy,
+    [OP_CS_SAXPY]        = glblas_cs_src_saxpy,
+    [OP_CS_SDOT]         = glblas_cs_src_sdot,
+    [OP_CS_SASUM]        = glblas_cs_src_sasum,
+    [OP_CS_REDUCE]       = glblas_cs_src_reduce,
+    [OP_CS_REDUCE_FINAL] = glblas_cs_src_reduce_final,
+    [OP_CS_SGEMM]        = glblas_cs_src_sgemm,
+    [OP_CS_ISAMAX]        = glblas_cs_src_isamax,
+    [OP_CS_ISAMAX_REDUCE] = glblas_cs_src_isamax_reduce,
+    [OP_CS_ISAMAX_FINAL]  = glblas_cs_src_isamax_final,
+    [OP_CS_SNRM2]         = glblas_cs_src_snrm2,
+    [OP_CS_SNRM2_FINAL]   = glblas_cs_src_snrm2_final,
+    [OP_CS_SROT]          = glblas_cs_src_srot,
+    [OP_CS_SSWAP]         = glblas_cs_src_sswap,
+    [OP_CS_SGEMV]         = glblas_cs_src_sgemv,
+    [OP_CS_SGEMV_PARTIAL] = glblas_cs_src_sgemv_partial,
+    [OP_CS_SGEMV_SUM]     = glblas_cs_src_sgemv_sum,
+    [OP_CS_SGER]          = glblas_cs_src_sger,
+    [OP_CS_SSYRK]         = glblas_cs_src_ssyrk,
+    [OP_CS_STRSM]         = glblas_cs_src_strsm
 };
 
-_glblas_internal_buffer *buffers = NULL;
+/*
+ * buffer registry: glblasMemory_t is a tagged (index, generation) pair into
+ * `registry.slots` rather than a pointer. handles always have the low bit set,
+ * which no float-aligned host pointer has, so glblasMemcpyInfer can tell them
+ * apart; the generation is bumped on free so stale handles fail to resolve.
+ * glblasMemcpy has no handle argument, so this is the one piece of state that
+ * is process wide rather than per context; `lock` guards it.
+ */
+#define HANDLE_INDEX_BITS 24
+#define HANDLE_INDEX_MASK ((1 << HANDLE_INDEX_BITS) - 1)
+
+typedef struct _glblas_internal_slot {
+    _glblas_internal_buffer *buffer;
+    unsigned int generation;
+    int next_free;
+} _glblas_internal_slot;
+
+static struct {
+    pthread_mutex_t lock;
+    _glblas_internal_slot *slots;
+    int count;
+    int capacity;
+    int free_head;
+} registry = { .lock = PTHREAD_MUTEX_INITIALIZER, .free_head = -1 };
 
 static const EGLint egl_generic_config[] = {
     EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
@@ -607,68 +1904,345 @@ static const EGLint egl_generic_config[] = {
     EGL_NONE
 };
 
-static void *dynarr_alloc(void **root, size_t next_offset, size_t size)
-{
-    if (*root == NULL) {
-        *root = calloc(1, size);
-        return *root;
-    }
+// no surface needed, device displays often expose no pbuffer configs
+static const EGLint egl_surfaceless_config[] = {
+    EGL_SURFACE_TYPE, 0,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_NONE
+};
 
-    void *next;
-    for (next = *root; *(void**)(next + next_offset); next = *(void**)(next + next_offset));
+#define MAX_EGL_DEVICES 16
 
-    *(void**)(next + next_offset) = calloc(1, size);
-    return *(void**)(next + next_offset);
+static inline glblasMemory_t encode_handle(int index, unsigned int generation)
+{
+    return (glblasMemory_t)(((uintptr_t)generation << (HANDLE_INDEX_BITS + 1)) | ((uintptr_t)index << 1) | 1);
 }
 
-static void dynarr_free_element(void **root, size_t next_offset, void *data)
+static glblasMemory_t registry_insert(_glblas_internal_buffer *buf)
 {
-    void *prev = NULL;
+    glblasMemory_t handle = NULL;
 
-    for (void *elem = *root; elem;) {
-        void *next = *(void**)(elem + next_offset);
+    pthread_mutex_lock(&registry.lock);
 
-        if (elem == data) {
-            if (prev == NULL)
-                *root = next;
-            else
-                *(void**)(prev + next_offset) = next;
+    int index = registry.free_head;
 
-            free(elem);
-        }
-        else
-            prev = elem;
+    if (index != -1) {
+        registry.free_head = registry.slots[index].next_free;
+    }
+    else {
+        if (registry.count == HANDLE_INDEX_MASK + 1)
+            goto out;
+
+        if (registry.count == registry.capacity) {
+            int capacity = MAX(64, registry.capacity * 2);
+            _glblas_internal_slot *slots = realloc(registry.slots, capacity * sizeof(_glblas_internal_slot));
+            if (slots == NULL)
+                goto out;
+
+            registry.slots = slots;
+            registry.capacity = capacity;
+        }
+
+        index = registry.count++;
+        registry.slots[index].generation = 0;
+    }
+
+    registry.slots[index].buffer = buf;
+    registry.slots[index].next_free = -1;
+
+    handle = encode_handle(index, registry.slots[index].generation);
+
+out:
+    pthread_mutex_unlock(&registry.lock);
+    return handle;
+}
+
+static void registry_remove(glblasMemory_t handle)
+{
+    int index = ((uintptr_t)handle >> 1) & HANDLE_INDEX_MASK;
+
+    pthread_mutex_lock(&registry.lock);
+
+    registry.slots[index].buffer = NULL;
+    registry.slots[index].generation++;
+    registry.slots[index].next_free = registry.free_head;
+    registry.free_head = index;
+
+    pthread_mutex_unlock(&registry.lock);
+}
+
+static inline _glblas_internal_buffer *get_buffer_from_handle(const void *handle)
+{
+    uintptr_t value = (uintptr_t)handle;
+    int index = (value >> 1) & HANDLE_INDEX_MASK;
+    _glblas_internal_buffer *buf = NULL;
+
+    if (!(value & 1))
+        return NULL;
+
+    pthread_mutex_lock(&registry.lock);
+
+    if (index < registry.count) {
+        _glblas_internal_slot *slot = &registry.slots[index];
+        if (slot->buffer && encode_handle(index, slot->generation) == handle)
+            buf = slot->buffer;
+    }
+
+    pthread_mutex_unlock(&registry.lock);
+    return buf;
+}
+
+// the buffer in slot `index` if it belongs to `context`, used to sweep a context's buffers
+static _glblas_internal_buffer *registry_owned(int index, _glblas_internal_context *context)
+{
+    _glblas_internal_buffer *buf = NULL;
+
+    pthread_mutex_lock(&registry.lock);
+
+    if (index < registry.count && registry.slots[index].buffer && registry.slots[index].buffer->context == context)
+        buf = registry.slots[index].buffer;
+
+    pthread_mutex_unlock(&registry.lock);
+    return buf;
+}
+
+static inline int registry_count()
+{
+    pthread_mutex_lock(&registry.lock);
+    int count = registry.count;
+    pthread_mutex_unlock(&registry.lock);
+
+    return count;
+}
+
+/*
+ * handles are independent: each owns its egl context, programs, buffers and
+ * state, so different handles can be driven from different threads. an egl
+ * context can only be current on one thread at a time, so every entry point
+ * makes its handle's context current first; this is a no-op in the common case
+ * of one handle per thread. binding fails if the context is still current on
+ * another thread, see glblasRelease.
+ */
+static inline bool bind_context(_glblas_internal_context *context)
+{
+    if (eglGetCurrentContext() == context->egl_context)
+        return true;
+
+    return eglMakeCurrent(context->dpy, context->surface, context->surface, context->egl_context);
+}
+
+static void fusion_flush(_glblas_internal_context *context);
+
+// bind, then run anything recorded in deferred mode; only the recording kernels use bind_context alone
+static inline bool make_current(_glblas_internal_context *context)
+{
+    if (!bind_context(context))
+        return false;
+
+    if (context->fusion.n_ops)
+        fusion_flush(context);
+
+    return true;
+}
+
+/*
+ * state tracking: kernels go through these instead of calling gl directly, so
+ * back-to-back calls on the same buffers (e.g. a chain of saxpys) don't re-issue
+ * identical binds. anything that changes gl state behind their back must keep
+ * context->state in sync.
+ */
+static inline void state_viewport(_glblas_internal_context *context, int width, int height)
+{
+    if (context->state.viewport_width == width && context->state.viewport_height == height) {
+        context->state.elided++;
+        return;
+    }
+
+    glViewport(0, 0, width, height);
+    context->state.viewport_width = width;
+    context->state.viewport_height = height;
+}
+
+static inline void state_use_program(_glblas_internal_context *context, unsigned int program)
+{
+    if (context->state.program == program) {
+        context->state.elided++;
+        return;
+    }
+
+    glUseProgram(program);
+    context->state.program = program;
+}
+
+static inline void state_bind_texture(_glblas_internal_context *context, unsigned int unit, unsigned int texture)
+{
+    if (context->state.textures[unit] == texture) {
+        context->state.elided++;
+        return;
+    }
+
+    if (context->state.active_texture != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        context->state.active_texture = unit;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    context->state.textures[unit] = texture;
+}
+
+static inline void state_bind_framebuffer(_glblas_internal_context *context, unsigned int framebuffer)
+{
+    if (context->state.framebuffer == framebuffer) {
+        context->state.elided++;
+        return;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    context->state.framebuffer = framebuffer;
+}
+
+static inline void state_bind_vertex_array(_glblas_internal_context *context, unsigned int vertex_array)
+{
+    if (context->state.vertex_array == vertex_array) {
+        context->state.elided++;
+        return;
+    }
+
+    glBindVertexArray(vertex_array);
+    context->state.vertex_array = vertex_array;
+}
+
+// image unit 0 is the output of compute kernels
+static inline void state_bind_image(_glblas_internal_context *context, unsigned int texture)
+{
+    if (context->state.image == texture) {
+        context->state.elided++;
+        return;
+    }
+
+    glBindImageTexture(0, texture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    context->state.image = texture;
+}
 
-        elem = next;
+// gl silently unbinds deleted objects, mirror that
+static void state_forget(_glblas_internal_context *context, unsigned int texture, unsigned int framebuffer)
+{
+    for (int i = 0; i < MAX_TEXTURE_UNITS; i++) {
+        if (context->state.textures[i] == texture)
+            context->state.textures[i] = 0;
     }
+
+    if (context->state.framebuffer == framebuffer)
+        context->state.framebuffer = 0;
+
+    if (context->state.image == texture)
+        context->state.image = 0;
 }
 
-static void dynarr_free(void **root, size_t next_offset)
+static void upload_params(_glblas_internal_context *context, const _glblas_internal_params *params)
 {
-    if (*(void**)(root)) {
-        dynarr_free(*(void**)(root + next_offset), next_offset);
-        free(*root);
+    if (context->state.params_valid && memcmp(&context->state.params, params, sizeof(_glblas_internal_params)) == 0) {
+        context->state.elided++;
+        return;
     }
+
+    // the ubo stays bound to GL_UNIFORM_BUFFER from glblasCreate
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(_glblas_internal_params), params);
+    context->state.params = *params;
+    context->state.params_valid = true;
+}
+
+static int egl_query_devices(EGLDeviceEXT *devices)
+{
+    EGLint count = 0;
+
+    // client extensions, queried without a display
+    if (!epoxy_has_egl_extension(EGL_NO_DISPLAY, "EGL_EXT_device_enumeration") || !epoxy_has_egl_extension(EGL_NO_DISPLAY, "EGL_EXT_platform_device"))
+        return 0;
+
+    if (!eglQueryDevicesEXT(MAX_EGL_DEVICES, devices, &count))
+        return 0;
+
+    return count;
 }
 
-static bool egl_initialize(_glblas_internal_context *context, int pbuffer_width, int pbuffer_height)
+/*
+ * device -1 opens EGL_DEFAULT_DISPLAY (so EGL_PLATFORM etc. still apply), any
+ * other value indexes the devices of EGL_EXT_device_enumeration and opens it
+ * through EGL_EXT_platform_device. kernels only ever render into their own
+ * fbos, so with EGL_KHR_surfaceless_context no surface is created at all;
+ * otherwise a 1x1 pbuffer is made just to have something to make current.
+ */
+static bool egl_initialize(_glblas_internal_context *context, int device)
 {
     EGLint pb_attr[] = {
-        EGL_WIDTH, pbuffer_width,
-        EGL_HEIGHT, pbuffer_height,
+        EGL_WIDTH, 1,
+        EGL_HEIGHT, 1,
         EGL_NONE,
     };
 
-    context->dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
-    if (!eglInitialize(context->dpy, &context->major, &context->minor))
+    if (device < 0) {
+        context->dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    else {
+        EGLDeviceEXT devices[MAX_EGL_DEVICES];
+        if (device >= egl_query_devices(devices))
+            return false;
+
+        context->dpy = eglGetPlatformDisplayEXT(EGL_PLATFORM_DEVICE_EXT, devices[device], NULL);
+    }
+
+    if (context->dpy == EGL_NO_DISPLAY || !eglInitialize(context->dpy, &context->major, &context->minor))
+        return false;
+
+    bool surfaceless = epoxy_has_egl_extension(context->dpy, "EGL_KHR_surfaceless_context");
+
+    eglChooseConfig(context->dpy, surfaceless ? egl_surfaceless_config : egl_generic_config, &context->config, 1, &context->n_config);
+    if (context->n_config == 0)
         return false;
 
-    eglChooseConfig(context->dpy, egl_generic_config, &context->config, 1, &context->n_config);
-    context->surface = eglCreatePbufferSurface(context->dpy, context->config, pb_attr);
     eglBindAPI(EGL_OPENGL_API);
     context->egl_context = eglCreateContext(context->dpy, context->config, EGL_NO_CONTEXT, NULL);
+    if (context->egl_context == EGL_NO_CONTEXT)
+        return false;
+
+    context->surface = surfaceless ? EGL_NO_SURFACE : eglCreatePbufferSurface(context->dpy, context->config, pb_attr);
+
+    return eglMakeCurrent(context->dpy, context->surface, context->surface, context->egl_context);
+}
+
+glblasStatus_t glblasGetDeviceCount(int *count)
+{
+    EGLDeviceEXT devices[MAX_EGL_DEVICES];
+
+    GLBLAS_ASSERT_STATUS(count, GLBLAS_STATUS_INVALID_VALUE);
+
+    *count = egl_query_devices(devices);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+glblasStatus_t glblasGetDeviceName(int device, char *name, size_t size)
+{
+    EGLDeviceEXT devices[MAX_EGL_DEVICES];
+    const char *str = NULL;
+
+    GLBLAS_ASSERT_STATUS(name && size, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(device >= 0 && device < egl_query_devices(devices), GLBLAS_STATUS_INVALID_VALUE);
 
-    return eglMakeCurrent(context->dpy, context->surface, context->surface, context->egl_context) != EGL_NOT_INITIALIZED;
+    const char *extensions = eglQueryDeviceStringEXT(devices[device], EGL_EXTENSIONS);
+
+    // prefer the render node, then the primary node; software devices have neither
+    if (extensions && strstr(extensions, "EGL_EXT_device_drm_render_node"))
+        str = eglQueryDeviceStringEXT(devices[device], EGL_DRM_RENDER_NODE_FILE_EXT);
+    if (str == NULL && extensions && strstr(extensions, "EGL_EXT_device_drm"))
+        str = eglQueryDeviceStringEXT(devices[device], EGL_DRM_DEVICE_FILE_EXT);
+    if (str == NULL)
+        str = "software";
+
+    snprintf(name, size, "%s", str);
+
+    return GLBLAS_STATUS_SUCCESS;
 }
 
 static int check_shader_errors(GLuint shader)
@@ -688,36 +2262,268 @@ static int check_shader_errors(GLuint shader)
     return status;
 }
 
-glblasStatus_t glblasCreate(glblasHandle_t *handle, int width, int height)
+/*
+ * programs are built on first use, so a process only pays for the kernels it
+ * calls. linked binaries are kept in an on-disk cache ($GLBLAS_CACHE_DIR, else
+ * $XDG_CACHE_HOME/glblas, else ~/.cache/glblas; an empty GLBLAS_CACHE_DIR
+ * disables it), one file per program named by a hash of the driver's vendor,
+ * renderer and version strings and both shader sources. a binary the driver
+ * rejects is rebuilt from source and overwritten.
+ */
+#define FNV_OFFSET 0xcbf29ce484222325ull
+#define FNV_PRIME 0x100000001b3ull
+
+static uint64_t fnv1a(uint64_t hash, const char *str)
 {
-    _glblas_internal_context *context = calloc(1, sizeof(_glblas_internal_context));
+    for (; *str; str++) {
+        hash ^= (unsigned char)*str;
+        hash *= FNV_PRIME;
+    }
 
-    if (!egl_initialize(context, width, height)) {
-        free(context);
-        return GLBLAS_STATUS_ALLOC_FAILED;
+    // terminator too, so ("ab", "c") and ("a", "bc") differ
+    return (hash ^ 0xff) * FNV_PRIME;
+}
+
+static bool make_dirs(const char *path)
+{
+    char buf[PATH_MAX];
+    snprintf(buf, sizeof(buf), "%s", path);
+
+    for (char *p = buf + 1; ; p++) {
+        if (*p != '/' && *p != '\0')
+            continue;
+
+        char c = *p;
+        *p = '\0';
+        if (mkdir(buf, 0755) != 0 && errno != EEXIST)
+            return false;
+        *p = c;
+
+        if (c == '\0')
+            return true;
+    }
+}
+
+static void cache_init(_glblas_internal_context *context)
+{
+    const char *dir = getenv("GLBLAS_CACHE_DIR");
+    const char *base;
+    int formats = 0;
+
+    context->cache_dir[0] = '\0';
+
+    if (epoxy_gl_version() >= 41 || epoxy_has_gl_extension("GL_ARB_get_program_binary"))
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats == 0)
+        return;
+
+    if (dir)
+        snprintf(context->cache_dir, sizeof(context->cache_dir), "%s", dir);
+    else if ((base = getenv("XDG_CACHE_HOME")) && *base)
+        snprintf(context->cache_dir, sizeof(context->cache_dir), "%s/glblas", base);
+    else if ((base = getenv("HOME")) && *base)
+        snprintf(context->cache_dir, sizeof(context->cache_dir), "%s/.cache/glblas", base);
+
+    if (context->cache_dir[0] && !make_dirs(context->cache_dir))
+        context->cache_dir[0] = '\0';
+
+    context->driver_hash = fnv1a(FNV_OFFSET, (const char*)glGetString(GL_VENDOR));
+    context->driver_hash = fnv1a(context->driver_hash, (const char*)glGetString(GL_RENDERER));
+    context->driver_hash = fnv1a(context->driver_hash, (const char*)glGetString(GL_VERSION));
+}
+
+// "#version" and the variant's defines, prepended to the op's source
+static void variant_header(int op, int variant, char *header, size_t size)
+{
+    int length = snprintf(header, size, "#version %s core\n", op >= OP_CS_SSCAL ? "430" : "330");
+
+    for (int i = 0; i < sizeof(variant_defines) / sizeof(variant_defines[0]); i++) {
+        if (variant & (1 << i))
+            length += snprintf(header + length, size - length, "%s", variant_defines[i]);
     }
+}
 
-    // compile shaders
-    for (int i = 0; i < OP_MAX; i++) {
-        shaders[i].id = glCreateShader(i != OP_GENERIC ? GL_FRAGMENT_SHADER : GL_VERTEX_SHADER);
-        glShaderSource(shaders[i].id, 1, &shaders[i].src, NULL);
-        glCompileShader(shaders[i].id);
+// identifies a program built from `header` + `source` (plus the shared vertex stage) on this driver
+static uint64_t program_hash(_glblas_internal_context *context, const char *header, const char *source)
+{
+    uint64_t hash = fnv1a(context->driver_hash, shader_sources[OP_GENERIC]);
+    hash = fnv1a(hash, header);
+
+    return fnv1a(hash, source);
+}
+
+static void cache_path(_glblas_internal_context *context, uint64_t hash, char *path, size_t size)
+{
+    snprintf(path, size, "%s/%016llx.bin", context->cache_dir, (unsigned long long)hash);
+}
+
+// file layout: binary format (GLenum), then the binary
+static unsigned int cache_load(_glblas_internal_context *context, uint64_t hash)
+{
+    char path[PATH_MAX];
+    unsigned int program = 0;
+    GLenum format;
+    GLint status;
+
+    if (context->cache_dir[0] == '\0')
+        return 0;
+
+    cache_path(context, hash, path, sizeof(path));
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+        return 0;
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file) - (long)sizeof(format);
+    fseek(file, 0, SEEK_SET);
+
+    void *binary = length > 0 ? malloc(length) : NULL;
+    if (binary && fread(&format, sizeof(format), 1, file) == 1 && fread(binary, length, 1, file) == 1) {
+        program = glCreateProgram();
+        glProgramBinary(program, format, binary, length);
+
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (status == GL_FALSE) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+
+    free(binary);
+    fclose(file);
+
+    return program;
+}
+
+static void cache_store(_glblas_internal_context *context, uint64_t hash, unsigned int program)
+{
+    char path[PATH_MAX];
+    char temp[PATH_MAX + 32];
+    GLenum format;
+    GLint length = 0;
+
+    if (context->cache_dir[0] == '\0')
+        return;
+
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    void *binary = malloc(length);
+    if (binary == NULL)
+        return;
+
+    glGetProgramBinary(program, length, &length, &format, binary);
+
+    // write then rename, so concurrent processes never see a partial file
+    cache_path(context, hash, path, sizeof(path));
+    snprintf(temp, sizeof(temp), "%s.%ld.tmp", path, (long)getpid());
+
+    FILE *file = fopen(temp, "wb");
+    if (file) {
+        bool ok = fwrite(&format, sizeof(format), 1, file) == 1 && fwrite(binary, length, 1, file) == 1;
+        ok &= fclose(file) == 0;
+
+        if (!ok || rename(temp, path) != 0)
+            remove(temp);
+    }
+
+    free(binary);
+}
+
+static unsigned int compile_shader(unsigned int type, const char *header, const char *source)
+{
+    const char *strings[] = { header, source };
+
+    unsigned int id = glCreateShader(type);
+    glShaderSource(id, 2, strings, NULL);
+    glCompileShader(id);
+
+    GLBLAS_ASSERT(check_shader_errors(id), "failed to compile shader:\n%s%s\n", header, source);
+    // GLBLAS_ASSERT_STATUS(check_shader_errors(id), GLBLAS_STATUS_NOT_SUPPORTED);
+
+    return id;
+}
+
+// link a compute program, or a fragment program behind the shared vertex stage
+static unsigned int build_program(_glblas_internal_context *context, bool compute, const char *header, const char *source)
+{
+    unsigned int id = compile_shader(compute ? GL_COMPUTE_SHADER : GL_FRAGMENT_SHADER, header, source);
+    unsigned int program = glCreateProgram();
+
+    // the vertex stage is shared, compile it once per context
+    if (!compute) {
+        if (context->vertex_shader == 0)
+            context->vertex_shader = compile_shader(GL_VERTEX_SHADER, "#version 330 core\n", shader_sources[OP_GENERIC]);
+        glAttachShader(program, context->vertex_shader);
+    }
+
+    glAttachShader(program, id);
+    if (context->cache_dir[0])
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program);
+    glDetachShader(program, id);
+    glDeleteShader(id);
+
+    return program;
+}
+
+// load or build a program, then resolve its sampler units and uniform blocks (none of which survive glProgramBinary)
+static unsigned int load_program(_glblas_internal_context *context, bool compute, const char *header, const char *source)
+{
+    uint64_t hash = program_hash(context, header, source);
+
+    unsigned int program = cache_load(context, hash);
+    if (program == 0) {
+        program = build_program(context, compute, header, source);
+        cache_store(context, hash, program);
+    }
+
+    state_use_program(context, program);
+    for (int j = 0; j < sizeof(sampler_units) / sizeof(sampler_units[0]); j++) {
+        int location = glGetUniformLocation(program, sampler_units[j].name);
+        if (location != -1)
+            glUniform1i(location, sampler_units[j].unit);
+    }
+
+    unsigned int block = glGetUniformBlockIndex(program, "Params");
+    if (block != GL_INVALID_INDEX)
+        glUniformBlockBinding(program, block, PARAMS_BINDING);
+
+    block = glGetUniformBlockIndex(program, "Fused");
+    if (block != GL_INVALID_INDEX)
+        glUniformBlockBinding(program, block, FUSED_BINDING);
+
+    return program;
+}
+
+// `op` in `variant`, built on first use
+static unsigned int get_program(_glblas_internal_context *context, int op, int variant)
+{
+    unsigned int *program = &context->programs[op][variant];
 
-        GLBLAS_ASSERT(check_shader_errors(shaders[i].id), "failed to compile shader %d\n", i);
-        // GLBLAS_ASSERT_STATUS(check_shader_errors(shaders[i].id), GLBLAS_STATUS_NOT_SUPPORTED);
+    if (*program == 0) {
+        char header[256];
+        variant_header(op, variant, header, sizeof(header));
+        *program = load_program(context, op >= OP_CS_SSCAL, header, shader_sources[op]);
     }
 
-    // link shaders
-    for (int i = OP_GENERIC + 1; i < OP_MAX; i++) {
-        shaders[i].program = glCreateProgram();
-        glAttachShader(shaders[i].program, shaders[OP_GENERIC].id);
-        glAttachShader(shaders[i].program, shaders[i].id);
-        glLinkProgram(shaders[i].program);
-        glDeleteShader(shaders[i].id);
+    return *program;
+}
+
+glblasStatus_t glblasCreateOnDevice(glblasHandle_t *handle, int device, int width, int height)
+{
+    _glblas_internal_context *context = calloc(1, sizeof(_glblas_internal_context));
+
+    GLBLAS_ASSERT_STATUS(handle && context, GLBLAS_STATUS_ALLOC_FAILED);
+
+    if (!egl_initialize(context, device)) {
+        free(context);
+        return GLBLAS_STATUS_ALLOC_FAILED;
     }
 
-    // delete generic
-    glDeleteShader(shaders[OP_GENERIC].id);
+    cache_init(context);
 
     float vertices[] = {
         // positions                        // texture coords
@@ -736,7 +2542,7 @@ glblasStatus_t glblasCreate(glblasHandle_t *handle, int width, int height)
     glGenBuffers(1, &context->VBO);
     glGenBuffers(1, &context->EBO);
 
-    glBindVertexArray(context->VAO);
+    state_bind_vertex_array(context, context->VAO);
 
     glBindBuffer(GL_ARRAY_BUFFER, context->VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
@@ -752,38 +2558,120 @@ glblasStatus_t glblasCreate(glblasHandle_t *handle, int width, int height)
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
-    context->pbuffer_host = calloc(width * height * FLOATS_PER_PIXEL, sizeof(float));
-    context->pbuffer_width = width;
-    context->pbuffer_height = height;
+    glGenBuffers(1, &context->UBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, context->UBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(_glblas_internal_params), NULL, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, PARAMS_BINDING, context->UBO);
+
+    // width only shapes the layout of buffers, capacity is whatever a texture can hold
+    int max_texture_size;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+
+    context->max_width = width > 0 ? MIN(width, max_texture_size) : max_texture_size;
+    context->max_height = max_texture_size;
+
+    context->scratch_limit = GLBLAS_SCRATCH_DEFAULT_LIMIT;
+    context->has_copy_image = epoxy_gl_version() >= 43 || epoxy_has_gl_extension("GL_ARB_copy_image");
+
+    // the compute kernels are #version 430, the extensions alone aren't enough
+    const char *backend = getenv("GLBLAS_BACKEND");
+    if (epoxy_gl_version() >= 43 && !(backend && strcmp(backend, "fragment") == 0))
+        context->backend = GLBLAS_BACKEND_COMPUTE;
+    else
+        context->backend = GLBLAS_BACKEND_FRAGMENT;
 
     *handle = context;
 
     return GLBLAS_STATUS_SUCCESS;
 }
 
+glblasStatus_t glblasCreate(glblasHandle_t *handle, int width, int height)
+{
+    return glblasCreateOnDevice(handle, -1, width, height);
+}
+
 void glblasSync()
 {
     glFinish();
 }
 
+glblasStatus_t glblasRelease(glblasHandle_t ctx)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+
+    GLBLAS_ASSERT_STATUS(context, GLBLAS_STATUS_INVALID_VALUE);
+
+    if (eglGetCurrentContext() == context->egl_context)
+        eglMakeCurrent(context->dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+glblasStatus_t glblasGetBackend(glblasHandle_t ctx, glblasBackend_t *backend)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+
+    GLBLAS_ASSERT_STATUS(context && backend, GLBLAS_STATUS_INVALID_VALUE);
+
+    *backend = context->backend;
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+glblasStatus_t glblasGetElidedBinds(glblasHandle_t ctx, size_t *count)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+
+    GLBLAS_ASSERT_STATUS(context && count, GLBLAS_STATUS_INVALID_VALUE);
+
+    *count = context->state.elided;
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+static void scratch_trim(_glblas_internal_context *context, size_t limit);
+
 void glblasDestroy(glblasHandle_t ctx)
 {
     _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+    if (context == NULL)
+        return;
+
+    make_current(context);
+    scratch_trim(context, 0);
+
+    glblasMemcpyWait(ctx);
+    for (int i = 0; i < TRANSFER_RING_SIZE; i++)
+        glDeleteBuffers(1, &context->transfers[i].pbo);
 
     glDeleteVertexArrays(1, &context->VAO);
     glDeleteBuffers(1, &context->VBO);
     glDeleteBuffers(1, &context->EBO);
-
-    for (_glblas_internal_buffer *buffer = buffers; buffer;) {
-        _glblas_internal_buffer *b = buffer;
-        buffer = b->next;
-        glblasFree(b);
+    glDeleteBuffers(1, &context->UBO);
+    glDeleteBuffers(1, &context->readback);
+
+    glDeleteFramebuffers(1, &context->mrt_framebuffer);
+    glDeleteBuffers(1, &context->fusion.UBO);
+    for (int i = 0; i < FUSE_PROGRAM_CACHE; i++)
+        glDeleteProgram(context->fusion.programs[i].program);
+
+    for (int i = 0, count = registry_count(); i < count; i++) {
+        _glblas_internal_buffer *buffer = registry_owned(i, context);
+        if (buffer)
+            glblasFree(buffer->handle);
     }
 
-    dynarr_free((void**)&buffers, 0);
+    for (int i = 0; i < OP_MAX; i++) {
+        for (int j = 0; j < VARIANT_MAX; j++)
+            glDeleteProgram(context->programs[i][j]);
+    }
+    glDeleteShader(context->vertex_shader);
 
-    for (int i = 0; i < OP_MAX; i++)
-        glDeleteProgram(shaders[i].program);
+    // the display is shared by every handle in the process, so it isn't terminated here
+    eglMakeCurrent(context->dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(context->dpy, context->egl_context);
+    if (context->surface != EGL_NO_SURFACE)
+        eglDestroySurface(context->dpy, context->surface);
 
     free(ctx);
 }
@@ -796,602 +2684,2536 @@ static glblasStatus_t get_texture_dimensions(size_t size, int max_width, int max
     if (is_padded)
         *is_padded = roundf((float)size / (FLOATS_PER_PIXEL * sizeof(float))) != ((float)size / (FLOATS_PER_PIXEL * sizeof(float)));
 
-    // check if buffer is tiny
-    if (count <= max_width) {
-        *out_width = count;
-        *out_height = 1;
+    // check if buffer is tiny
+    if (count <= max_width) {
+        *out_width = count;
+        *out_height = 1;
+        return GLBLAS_STATUS_SUCCESS;
+    }
+
+    // otherwise, (max_width, variable height)
+    *out_width = max_width;
+    *out_height = (count + max_width - 1) / max_width;
+    
+    return (*out_width <= max_width && *out_height <= max_height) ? GLBLAS_STATUS_SUCCESS : GLBLAS_STATUS_DIMENSION_OVERFLOW;
+}
+
+static void create_buffer_storage(_glblas_internal_buffer *buf, unsigned int format)
+{
+    buf->format = format;
+
+    glGenFramebuffers(1, &buf->framebuffer);
+    glGenTextures(1, &buf->texture_colorbuffer);
+    state_bind_framebuffer(buf->context, buf->framebuffer);
+    state_bind_texture(buf->context, buf->context->state.active_texture, buf->texture_colorbuffer);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, format, buf->width, buf->height, 0, GL_RGBA, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // GL_LINEAR changes the values, so use nearest
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, buf->texture_colorbuffer, 0);
+}
+
+static void destroy_buffer_storage(_glblas_internal_buffer *buf)
+{
+    state_forget(buf->context, buf->texture_colorbuffer, buf->framebuffer);
+
+    glDeleteFramebuffers(1, &buf->framebuffer);
+    glDeleteTextures(1, &buf->texture_colorbuffer);
+}
+
+static inline size_t get_buffer_footprint(const _glblas_internal_buffer *buf)
+{
+    return (size_t)buf->width * buf->height * FLOATS_PER_PIXEL * sizeof(float);
+}
+
+glblasMemory_t glblasMalloc(glblasHandle_t ctx, size_t size)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+    int width, height;
+    bool is_padded;
+
+    // too large for a single texture
+    if (context == NULL || size == 0 || get_texture_dimensions(size, context->max_width, context->max_height, &width, &height, &is_padded) != GLBLAS_STATUS_SUCCESS)
+        return NULL;
+
+    if (!make_current(context))
+        return NULL;
+
+    _glblas_internal_buffer *buf = calloc(1, sizeof(_glblas_internal_buffer));
+    if (buf == NULL)
+        return NULL;
+
+    buf->size = size;
+    buf->width = width;
+    buf->height = height;
+    buf->is_padded = is_padded;
+    buf->context = context;
+
+    while (glGetError() != GL_NO_ERROR)
+        ;
+
+    create_buffer_storage(buf, GL_RGBA32F);
+    if (glGetError() == GL_OUT_OF_MEMORY) {
+        destroy_buffer_storage(buf);
+        free(buf);
+        return NULL;
+    }
+
+    buf->handle = registry_insert(buf);
+    if (buf->handle == NULL) {
+        destroy_buffer_storage(buf);
+        free(buf);
+        return NULL;
+    }
+
+    return buf->handle;
+}
+
+/*
+ * scratch pool: kernel temporaries are drawn from and returned to a per-context
+ * free list keyed by (width, height, format), so repeated calls reuse the same
+ * texture and fbo instead of recreating them. pooled buffers are never
+ * registered, so they can't be freed or looked up through the public api.
+ */
+static _glblas_internal_buffer *scratch_acquire(_glblas_internal_context *context, size_t size)
+{
+    int width, height;
+    bool is_padded;
+    get_texture_dimensions(size, context->max_width, context->max_height, &width, &height, &is_padded);
+
+    _glblas_internal_buffer *prev = NULL;
+    _glblas_internal_buffer *buf;
+
+    for (buf = context->scratch; buf; prev = buf, buf = buf->next) {
+        if (buf->width == width && buf->height == height && buf->format == GL_RGBA32F)
+            break;
+    }
+
+    if (buf) {
+        if (prev == NULL)
+            context->scratch = buf->next;
+        else
+            prev->next = buf->next;
+
+        context->scratch_size -= get_buffer_footprint(buf);
+    }
+    else {
+        buf = calloc(1, sizeof(_glblas_internal_buffer));
+        buf->width = width;
+        buf->height = height;
+        buf->context = context;
+        create_buffer_storage(buf, GL_RGBA32F);
+    }
+
+    buf->next = NULL;
+    buf->size = size;
+    buf->is_padded = is_padded;
+
+    return buf;
+}
+
+static void scratch_trim(_glblas_internal_context *context, size_t limit)
+{
+    _glblas_internal_buffer **link = &context->scratch;
+    size_t kept = 0;
+
+    // keep the most recently released buffers that fit, free the rest
+    while (*link) {
+        _glblas_internal_buffer *buf = *link;
+        size_t footprint = get_buffer_footprint(buf);
+
+        if (kept + footprint <= limit) {
+            kept += footprint;
+            link = &buf->next;
+            continue;
+        }
+
+        *link = buf->next;
+        destroy_buffer_storage(buf);
+        free(buf);
+    }
+
+    context->scratch_size = kept;
+}
+
+static void scratch_release(_glblas_internal_buffer *buf)
+{
+    _glblas_internal_context *context = buf->context;
+
+    buf->next = context->scratch;
+    context->scratch = buf;
+    context->scratch_size += get_buffer_footprint(buf);
+
+    if (context->scratch_size > context->scratch_limit)
+        scratch_trim(context, context->scratch_limit);
+}
+
+glblasStatus_t glblasSetScratchLimit(glblasHandle_t ctx, size_t size)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+
+    GLBLAS_ASSERT_STATUS(context, GLBLAS_STATUS_INVALID_VALUE);
+
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    context->scratch_limit = size;
+    if (context->scratch_size > size)
+        scratch_trim(context, size);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+glblasStatus_t glblasTrimScratch(glblasHandle_t ctx, size_t size)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+
+    GLBLAS_ASSERT_STATUS(context, GLBLAS_STATUS_INVALID_VALUE);
+
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+    scratch_trim(context, size);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+static glblasMemcpyKind_t get_memcpy_kind(const _glblas_internal_buffer *buf_dst, const _glblas_internal_buffer *buf_src, glblasMemcpyKind_t kind)
+{
+    if (kind != glblasMemcpyInfer)
+        return kind;
+
+    if (buf_dst && buf_src)
+        return glblasMemcpyDeviceToDevice;
+    else if (buf_dst == NULL)
+        return glblasMemcpyDeviceToHost;
+    else
+        return glblasMemcpyHostToDevice;
+}
+
+// write `ragged` bytes into texel (x, y) of buf, whose texture is bound; the other lanes are kept unless they're only the buffer's padding
+static void upload_ragged_texel(_glblas_internal_context *context, _glblas_internal_buffer *buf, int x, int y, const void *src, size_t ragged, bool keep)
+{
+    float texel[FLOATS_PER_PIXEL] = { 0 };
+
+    if (keep) {
+        state_bind_framebuffer(context, buf->framebuffer);
+        glReadPixels(x, y, 1, 1, GL_RGBA, GL_FLOAT, texel);
+    }
+    memcpy(texel, src, ragged);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 1, 1, GL_RGBA, GL_FLOAT, texel);
+}
+
+glblasStatus_t glblasMemcpy(void *dst, void *src, size_t size, glblasMemcpyKind_t kind)
+{
+    _glblas_internal_buffer *buf_dst = get_buffer_from_handle(dst);
+    _glblas_internal_buffer *buf_src = get_buffer_from_handle(src);
+
+    _glblas_internal_buffer *buf;
+
+    // GLBLAS_ASSERT(buf_dst != NULL || buf_src != NULL, "invalid addresses (%p) (%p)\n", buf_dst, buf_src);
+    GLBLAS_ASSERT_STATUS(buf_dst != NULL || buf_src != NULL, GLBLAS_STATUS_INVALID_VALUE);
+
+    kind = get_memcpy_kind(buf_dst, buf_src, kind);
+
+    switch (kind) {
+    case glblasMemcpyHostToDevice:
+        buf = buf_dst;
+        break;
+    case glblasMemcpyDeviceToHost:
+        buf = buf_src;
+        break;
+    case glblasMemcpyDeviceToDevice:
+        return glblasMemcpyDevice(dst, 0, src, 0, size);
+    default:
+        break;
+    }
+
+    // GLBLAS_ASSERT(buf, "invalid buffer\n");
+    // GLBLAS_ASSERT(size <= buf->size, "size (%ld) is likely too large, buffer size is %ld\n", size, buf->size);
+
+    GLBLAS_ASSERT_STATUS(buf && size <= buf->size, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_context *context = buf->context;
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    /*
+     * whole rows and the whole texels of the last row go straight to/from the
+     * caller's memory; only a ragged final texel (size not a multiple of 16)
+     * bounces through a single texel on the stack.
+     */
+    size_t texel_size = FLOATS_PER_PIXEL * sizeof(float);
+    int texels = size / texel_size;
+    int rows = texels / buf->width;
+    int cols = texels % buf->width;
+    size_t ragged = size % texel_size;
+    size_t cols_offset = (size_t)rows * buf->width * texel_size;
+    float texel[FLOATS_PER_PIXEL] = { 0 };
+
+    switch (kind) {
+    case glblasMemcpyHostToDevice:
+        state_bind_texture(context, context->state.active_texture, buf->texture_colorbuffer);
+
+        if (rows)
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, buf->width, rows, GL_RGBA, GL_FLOAT, src);
+        if (cols)
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, rows, cols, 1, GL_RGBA, GL_FLOAT, src + cols_offset);
+        if (ragged)
+            upload_ragged_texel(context, buf, cols, rows, src + (size_t)texels * texel_size, ragged, size < buf->size);
+        break;
+
+    case glblasMemcpyDeviceToHost:
+        state_bind_framebuffer(context, buf->framebuffer);
+
+        if (rows)
+            glReadPixels(0, 0, buf->width, rows, GL_RGBA, GL_FLOAT, dst);
+        if (cols)
+            glReadPixels(0, rows, cols, 1, GL_RGBA, GL_FLOAT, dst + cols_offset);
+        if (ragged) {
+            glReadPixels(cols, rows, 1, 1, GL_RGBA, GL_FLOAT, texel);
+            memcpy(dst + (size_t)texels * texel_size, texel, ragged);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+/*
+ * device to device copies never touch the host or run a kernel when both ends
+ * start on a texel: the linear range is split into rectangles (whole rows when
+ * both textures share a width and are row aligned, otherwise row fragments)
+ * and moved with glCopyImageSubData, or glBlitFramebuffer where that's
+ * unavailable. anything left over that doesn't fill a whole texel goes through
+ * a single OP_MEMCPY pass, which only rewrites the affected lanes.
+ */
+static void copy_rect(_glblas_internal_context *context, _glblas_internal_buffer *dst, int dx, int dy, _glblas_internal_buffer *src, int sx, int sy, int width, int height)
+{
+    if (context->has_copy_image) {
+        glCopyImageSubData(src->texture_colorbuffer, GL_TEXTURE_2D, 0, sx, sy, 0,
+                           dst->texture_colorbuffer, GL_TEXTURE_2D, 0, dx, dy, 0,
+                           width, height, 1);
+        return;
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, src->framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dst->framebuffer);
+    glBlitFramebuffer(sx, sy, sx + width, sy + height, dx, dy, dx + width, dy + height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, context->state.framebuffer);
+}
+
+static void copy_texels(_glblas_internal_context *context, _glblas_internal_buffer *dst, int dst_texel, _glblas_internal_buffer *src, int src_texel, int count)
+{
+    while (count) {
+        int sx = src_texel % src->width, sy = src_texel / src->width;
+        int dx = dst_texel % dst->width, dy = dst_texel / dst->width;
+        int width, height;
+
+        if (sx == 0 && dx == 0 && src->width == dst->width && count >= src->width) {
+            width = src->width;
+            height = count / src->width;
+        }
+        else {
+            width = MIN(count, MIN(src->width - sx, dst->width - dx));
+            height = 1;
+        }
+
+        copy_rect(context, dst, dx, dy, src, sx, sy, width, height);
+
+        src_texel += width * height;
+        dst_texel += width * height;
+        count -= width * height;
+    }
+}
+
+static void copy_floats(_glblas_internal_context *context, _glblas_internal_buffer *dst, int dst_index, _glblas_internal_buffer *src, int src_index, int count)
+{
+    int last_row = ((dst_index + count - 1) / FLOATS_PER_PIXEL) / dst->width;
+
+    state_viewport(context, dst->width, last_row + 1);
+    state_use_program(context, get_program(context, OP_MEMCPY, 0));
+
+    state_bind_texture(context, 0, src->texture_colorbuffer);
+    state_bind_texture(context, 1, dst->texture_colorbuffer);
+
+    _glblas_internal_params params = {
+        .dims = { dst->width, dst->height },
+        .adims = { src->width, src->height },
+        .max_index = count,
+        .offx = src_index,
+        .offy = dst_index,
+    };
+    upload_params(context, &params);
+
+    state_bind_framebuffer(context, dst->framebuffer);
+    state_bind_vertex_array(context, context->VAO);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+}
+
+static void copy_buffer(_glblas_internal_buffer *dst, size_t dst_offset, _glblas_internal_buffer *src, size_t src_offset, size_t size)
+{
+    _glblas_internal_context *context = dst->context;
+    size_t texel_size = FLOATS_PER_PIXEL * sizeof(float);
+
+    if (size == 0)
+        return;
+
+    if (dst_offset % texel_size || src_offset % texel_size) {
+        copy_floats(context, dst, dst_offset / sizeof(float), src, src_offset / sizeof(float), size / sizeof(float));
+        return;
+    }
+
+    // a ragged end can be copied as a whole texel if the rest of it is just padding
+    size_t texels = size / texel_size;
+    size_t ragged = size % texel_size;
+    if (ragged && dst_offset + size >= dst->size) {
+        texels++;
+        ragged = 0;
+    }
+
+    copy_texels(context, dst, dst_offset / texel_size, src, src_offset / texel_size, texels);
+
+    if (ragged)
+        copy_floats(context, dst, (dst_offset + texels * texel_size) / sizeof(float), src, (src_offset + texels * texel_size) / sizeof(float), ragged / sizeof(float));
+}
+
+glblasStatus_t glblasMemcpyDevice(glblasMemory_t dst, size_t dst_offset, const glblasMemory_t src, size_t src_offset, size_t size)
+{
+    _glblas_internal_buffer *buf_dst = get_buffer_from_handle(dst);
+    _glblas_internal_buffer *buf_src = get_buffer_from_handle(src);
+
+    GLBLAS_ASSERT_STATUS(buf_dst && buf_src && buf_dst->context == buf_src->context, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(dst_offset % sizeof(float) == 0 && src_offset % sizeof(float) == 0 && size % sizeof(float) == 0, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(dst_offset + size <= buf_dst->size && src_offset + size <= buf_src->size, GLBLAS_STATUS_INVALID_VALUE);
+
+    GLBLAS_ASSERT_STATUS(make_current(buf_dst->context), GLBLAS_STATUS_EXECUTION_FAILED);
+    copy_buffer(buf_dst, dst_offset, buf_src, src_offset, size);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+/*
+ * async transfers stage through a small ring of pixel buffer objects. uploads
+ * copy into a mapped pbo and let glTexSubImage2D source from it, downloads
+ * glReadPixels into a pbo; either way the call returns once the commands are
+ * queued. each slot carries a fence, and a download is only copied out to the
+ * caller's pointer once its fence has signaled (on query/wait, or when the
+ * slot comes around again). only whole texels go through the pbo; the ragged
+ * end of an upload is merged into its texel like glblasMemcpy does, which
+ * reads that one texel back before returning.
+ */
+static bool transfer_complete(_glblas_internal_context *context, _glblas_internal_transfer *transfer, bool wait)
+{
+    if (transfer->fence == NULL)
+        return true;
+
+    GLenum result = glClientWaitSync(transfer->fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? UINT64_MAX : 0);
+    if (result == GL_TIMEOUT_EXPIRED)
+        return false;
+
+    glDeleteSync(transfer->fence);
+    transfer->fence = NULL;
+
+    if (transfer->dst) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, transfer->pbo);
+        void *ptr = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, transfer->size, GL_MAP_READ_BIT);
+        memcpy(transfer->dst, ptr, transfer->size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        transfer->dst = NULL;
+    }
+
+    return true;
+}
+
+static _glblas_internal_transfer *transfer_acquire(_glblas_internal_context *context, GLenum target, size_t size)
+{
+    _glblas_internal_transfer *transfer = &context->transfers[context->transfer_next];
+    context->transfer_next = (context->transfer_next + 1) % TRANSFER_RING_SIZE;
+
+    // ring is full, block on the oldest transfer
+    transfer_complete(context, transfer, true);
+
+    if (transfer->pbo == 0)
+        glGenBuffers(1, &transfer->pbo);
+
+    glBindBuffer(target, transfer->pbo);
+    if (transfer->capacity < size) {
+        glBufferData(target, size, NULL, target == GL_PIXEL_PACK_BUFFER ? GL_STREAM_READ : GL_STREAM_DRAW);
+        transfer->capacity = size;
+    }
+
+    return transfer;
+}
+
+glblasStatus_t glblasMemcpyAsync(void *dst, void *src, size_t size, glblasMemcpyKind_t kind)
+{
+    _glblas_internal_buffer *buf_dst = get_buffer_from_handle(dst);
+    _glblas_internal_buffer *buf_src = get_buffer_from_handle(src);
+
+    GLBLAS_ASSERT_STATUS(buf_dst != NULL || buf_src != NULL, GLBLAS_STATUS_INVALID_VALUE);
+
+    kind = get_memcpy_kind(buf_dst, buf_src, kind);
+
+    // nothing to stage, gpu side copies are already asynchronous
+    if (kind == glblasMemcpyDeviceToDevice)
+        return glblasMemcpy(dst, src, size, kind);
+
+    _glblas_internal_buffer *buf = kind == glblasMemcpyHostToDevice ? buf_dst : buf_src;
+
+    GLBLAS_ASSERT_STATUS(buf && size <= buf->size, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_context *context = buf->context;
+    _glblas_internal_transfer *transfer;
+    void *ptr;
+
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    size_t texel_size = FLOATS_PER_PIXEL * sizeof(float);
+    int texels = (size + texel_size - 1) / texel_size;
+    int rows = texels / buf->width;
+    int tail = texels % buf->width;
+    int whole = size / texel_size;
+    size_t ragged = size % texel_size;
+
+    switch (kind) {
+    case glblasMemcpyHostToDevice:
+        transfer = transfer_acquire(context, GL_PIXEL_UNPACK_BUFFER, whole * texel_size);
+        state_bind_texture(context, context->state.active_texture, buf->texture_colorbuffer);
+
+        if (whole) {
+            ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, whole * texel_size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+            memcpy(ptr, src, whole * texel_size);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+            int whole_rows = whole / buf->width;
+            int whole_tail = whole % buf->width;
+            if (whole_rows)
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, buf->width, whole_rows, GL_RGBA, GL_FLOAT, (void*)0);
+            if (whole_tail)
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, whole_rows, whole_tail, 1, GL_RGBA, GL_FLOAT, (void*)((size_t)whole_rows * buf->width * texel_size));
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        if (ragged)
+            upload_ragged_texel(context, buf, whole % buf->width, whole / buf->width, src + (size_t)whole * texel_size, ragged, size < buf->size);
+        break;
+
+    case glblasMemcpyDeviceToHost:
+        transfer = transfer_acquire(context, GL_PIXEL_PACK_BUFFER, texels * texel_size);
+
+        state_bind_framebuffer(context, buf->framebuffer);
+        if (rows)
+            glReadPixels(0, 0, buf->width, rows, GL_RGBA, GL_FLOAT, (void*)0);
+        if (tail)
+            glReadPixels(0, rows, tail, 1, GL_RGBA, GL_FLOAT, (void*)((size_t)rows * buf->width * texel_size));
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        transfer->dst = dst;
+        transfer->size = size;
+        break;
+
+    default:
+        return GLBLAS_STATUS_INVALID_VALUE;
+    }
+
+    transfer->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+glblasStatus_t glblasMemcpyQuery(glblasHandle_t ctx)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+    bool done = true;
+
+    GLBLAS_ASSERT_STATUS(context, GLBLAS_STATUS_INVALID_VALUE);
+
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    for (int i = 0; i < TRANSFER_RING_SIZE; i++)
+        done &= transfer_complete(context, &context->transfers[i], false);
+
+    return done ? GLBLAS_STATUS_SUCCESS : GLBLAS_STATUS_NOT_READY;
+}
+
+glblasStatus_t glblasMemcpyWait(glblasHandle_t ctx)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+
+    GLBLAS_ASSERT_STATUS(context, GLBLAS_STATUS_INVALID_VALUE);
+
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    // oldest first, so downloads land in issue order
+    for (int i = 0; i < TRANSFER_RING_SIZE; i++)
+        transfer_complete(context, &context->transfers[(context->transfer_next + i) % TRANSFER_RING_SIZE], true);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+/*
+ * events: a fence dropped into the handle's command stream. waiting on one only
+ * blocks until the work issued before it has retired, unlike glFinish which
+ * drains everything. async downloads whose fences have passed by then are
+ * copied out to the host, so their memory is valid once the event completes.
+ */
+static bool event_complete(_glblas_internal_event *event, bool wait)
+{
+    _glblas_internal_context *context = event->context;
+
+    if (event->fence) {
+        GLenum result = glClientWaitSync(event->fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? UINT64_MAX : 0);
+        if (result == GL_TIMEOUT_EXPIRED)
+            return false;
+
+        glDeleteSync(event->fence);
+        event->fence = NULL;
+    }
+
+    // anything issued before the fence has signaled too, so this won't block
+    for (int i = 0; i < TRANSFER_RING_SIZE; i++)
+        transfer_complete(context, &context->transfers[(context->transfer_next + i) % TRANSFER_RING_SIZE], false);
+
+    return true;
+}
+
+glblasStatus_t glblasEventCreate(glblasHandle_t ctx, glblasEvent_t *event)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+
+    GLBLAS_ASSERT_STATUS(context && event, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_event *ev = calloc(1, sizeof(_glblas_internal_event));
+    GLBLAS_ASSERT_STATUS(ev, GLBLAS_STATUS_ALLOC_FAILED);
+
+    ev->context = context;
+    *event = ev;
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+glblasStatus_t glblasEventRecord(glblasEvent_t event)
+{
+    _glblas_internal_event *ev = (_glblas_internal_event*)event;
+
+    GLBLAS_ASSERT_STATUS(ev, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(make_current(ev->context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    // re-recording moves the event to the current end of the stream
+    if (ev->fence)
+        glDeleteSync(ev->fence);
+
+    ev->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    GLBLAS_ASSERT_STATUS(ev->fence, GLBLAS_STATUS_EXECUTION_FAILED);
+
+    // make sure the fence reaches the gpu even if nobody waits with a flush
+    glFlush();
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+glblasStatus_t glblasEventQuery(glblasEvent_t event)
+{
+    _glblas_internal_event *ev = (_glblas_internal_event*)event;
+
+    GLBLAS_ASSERT_STATUS(ev, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(make_current(ev->context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    return event_complete(ev, false) ? GLBLAS_STATUS_SUCCESS : GLBLAS_STATUS_NOT_READY;
+}
+
+glblasStatus_t glblasEventSynchronize(glblasEvent_t event)
+{
+    _glblas_internal_event *ev = (_glblas_internal_event*)event;
+
+    GLBLAS_ASSERT_STATUS(ev, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(make_current(ev->context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    event_complete(ev, true);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+void glblasEventDestroy(glblasEvent_t event)
+{
+    _glblas_internal_event *ev = (_glblas_internal_event*)event;
+    if (ev == NULL)
+        return;
+
+    if (ev->fence && make_current(ev->context))
+        glDeleteSync(ev->fence);
+
+    free(ev);
+}
+
+glblasStatus_t glblasSynchronize(glblasHandle_t ctx)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+
+    GLBLAS_ASSERT_STATUS(context, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    _glblas_internal_event ev = {
+        .context = context,
+        .fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0),
+    };
+    GLBLAS_ASSERT_STATUS(ev.fence, GLBLAS_STATUS_EXECUTION_FAILED);
+
+    event_complete(&ev, true);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+void glblasFree(glblasMemory_t buf)
+{
+    _glblas_internal_buffer *buffer = get_buffer_from_handle(buf);
+    if (buffer == NULL)
+        return;
+    
+    if (!make_current(buffer->context))
+        return;
+    destroy_buffer_storage(buffer);
+
+    registry_remove(buf);
+    free(buffer);
+}
+
+// draw fragment `op` over the first `texels` texels of dst, in dst's own layout; fills in params->dims
+static void draw(_glblas_internal_context *context, int op, int variant, _glblas_internal_buffer *dst, int texels, _glblas_internal_params *params)
+{
+    int width = MIN(texels, dst->width);
+    int height = (texels + dst->width - 1) / dst->width;
+
+    state_viewport(context, width, height);
+    state_use_program(context, get_program(context, op, variant));
+
+    params->dims[0] = dst->width;
+    params->dims[1] = height;
+    upload_params(context, params);
+
+    state_bind_framebuffer(context, dst->framebuffer);
+    state_bind_vertex_array(context, context->VAO);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+}
+
+// make `targets` color attachments 0.. of the mrt framebuffer and draw into all of them
+static void bind_targets(_glblas_internal_context *context, _glblas_internal_buffer *const *targets, int count)
+{
+    GLenum draw_buffers[MAX_RENDER_TARGETS];
+
+    if (context->mrt_framebuffer == 0)
+        glGenFramebuffers(1, &context->mrt_framebuffer);
+    state_bind_framebuffer(context, context->mrt_framebuffer);
+
+    for (int i = 0; i < MAX_RENDER_TARGETS; i++) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, i < count ? targets[i]->texture_colorbuffer : 0, 0);
+        draw_buffers[i] = GL_COLOR_ATTACHMENT0 + i;
+    }
+    glDrawBuffers(count, draw_buffers);
+}
+
+// don't keep buffers attached past their lifetime
+static void release_targets(_glblas_internal_context *context, int count)
+{
+    for (int i = 0; i < count; i++)
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, 0, 0);
+}
+
+// draw writing x and y at once, as render targets 0 and 1; they must share a layout
+static void draw_pair(_glblas_internal_context *context, int op, int variant, _glblas_internal_buffer *x, _glblas_internal_buffer *y, int texels, _glblas_internal_params *params)
+{
+    _glblas_internal_buffer *targets[2] = { x, y };
+    int width = MIN(texels, x->width);
+    int height = (texels + x->width - 1) / x->width;
+
+    state_viewport(context, width, height);
+    state_use_program(context, get_program(context, op, variant));
+
+    params->dims[0] = x->width;
+    params->dims[1] = height;
+    upload_params(context, params);
+
+    bind_targets(context, targets, 2);
+    state_bind_vertex_array(context, context->VAO);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    release_targets(context, 2);
+}
+
+// run compute `op` over a groups_x by groups_y grid, writing dst through image unit 0
+static void dispatch_3d(_glblas_internal_context *context, int op, int variant, _glblas_internal_buffer *dst, int groups_x, int groups_y, int groups_z, const _glblas_internal_params *params)
+{
+    state_use_program(context, get_program(context, op, variant));
+    upload_params(context, params);
+    state_bind_image(context, dst->texture_colorbuffer);
+
+    glDispatchCompute(groups_x, groups_y, groups_z);
+
+    // image stores are incoherent; whatever reads dst next may be a draw, a copy or a readback
+    glMemoryBarrier(GL_ALL_BARRIER_BITS);
+}
+
+static inline void dispatch(_glblas_internal_context *context, int op, int variant, _glblas_internal_buffer *dst, int groups_x, int groups_y, const _glblas_internal_params *params)
+{
+    dispatch_3d(context, op, variant, dst, groups_x, groups_y, 1, params);
+}
+
+// `groups` workgroups, numbered by group_index() in the shader
+static inline void dispatch_linear(_glblas_internal_context *context, int op, int variant, _glblas_internal_buffer *dst, int groups, const _glblas_internal_params *params)
+{
+    int groups_x = MAX(1, MIN(groups, CS_MAX_GROUPS));
+    dispatch(context, op, variant, dst, groups_x, (groups + groups_x - 1) / groups_x, params);
+}
+
+// texels holding N floats
+static inline int texel_count(int N)
+{
+    return (MAX(N, 0) + FLOATS_PER_PIXEL - 1) / FLOATS_PER_PIXEL;
+}
+
+// workgroups for an element-wise kernel over N floats, one texel per invocation
+static inline int elementwise_groups(int N)
+{
+    return MAX(1, (texel_count(N) + CS_GROUP_SIZE - 1) / CS_GROUP_SIZE);
+}
+
+/*
+ * pointer mode: in host mode scalars are host floats and sdot/sasum results
+ * land in host memory; in device mode they are device buffers (only the first
+ * float is used), so results can feed later kernels without a round trip.
+ */
+glblasStatus_t glblasSetPointerMode(glblasHandle_t ctx, glblasPointerMode_t mode)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+
+    GLBLAS_ASSERT_STATUS(context, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(mode == GLBLAS_POINTER_MODE_HOST || mode == GLBLAS_POINTER_MODE_DEVICE, GLBLAS_STATUS_INVALID_VALUE);
+
+    context->pointer_mode = mode;
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+glblasStatus_t glblasGetPointerMode(glblasHandle_t ctx, glblasPointerMode_t *mode)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+
+    GLBLAS_ASSERT_STATUS(context && mode, GLBLAS_STATUS_INVALID_VALUE);
+
+    *mode = context->pointer_mode;
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+static glblasStatus_t get_scalar(_glblas_internal_context *context, const float *ptr, _glblas_internal_scalar *scalar)
+{
+    GLBLAS_ASSERT_STATUS(ptr, GLBLAS_STATUS_INVALID_VALUE);
+
+    if (context->pointer_mode == GLBLAS_POINTER_MODE_HOST) {
+        *scalar = (_glblas_internal_scalar){ .value = *ptr };
+        return GLBLAS_STATUS_SUCCESS;
+    }
+
+    _glblas_internal_buffer *buffer = get_buffer_from_handle(ptr);
+    GLBLAS_ASSERT_STATUS(buffer && buffer->context == context, GLBLAS_STATUS_INVALID_VALUE);
+
+    *scalar = (_glblas_internal_scalar){ .buffer = buffer };
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+// bind device side scalars for GLSL_SCALARS, returns the params scalar_mode
+// variant bits implied by the scalars, only known up front for host values
+static inline int scalar_variant(const _glblas_internal_scalar *alpha, const _glblas_internal_scalar *beta)
+{
+    int variant = 0;
+
+    if (alpha && alpha->buffer == NULL && alpha->value == 1.0f)
+        variant |= VARIANT_ALPHA_ONE;
+    if (beta && beta->buffer == NULL && beta->value == 0.0f)
+        variant |= VARIANT_BETA_ZERO;
+
+    return variant;
+}
+
+static int bind_scalars(_glblas_internal_context *context, const _glblas_internal_scalar *alpha, const _glblas_internal_scalar *beta)
+{
+    int mode = 0;
+
+    if (alpha && alpha->buffer) {
+        state_bind_texture(context, 3, alpha->buffer->texture_colorbuffer);
+        mode |= SCALAR_ALPHA_DEVICE;
+    }
+
+    if (beta && beta->buffer) {
+        state_bind_texture(context, 4, beta->buffer->texture_colorbuffer);
+        mode |= SCALAR_BETA_DEVICE;
+    }
+
+    return mode;
+}
+
+// where sdot/sasum write: the caller's buffer in device mode, a pooled texel in host mode
+static _glblas_internal_buffer *result_acquire(_glblas_internal_context *context, void *result)
+{
+    if (context->pointer_mode == GLBLAS_POINTER_MODE_HOST)
+        return result ? scratch_acquire(context, sizeof(float)) : NULL;
+
+    _glblas_internal_buffer *buffer = get_buffer_from_handle(result);
+    return buffer && buffer->context == context ? buffer : NULL;
+}
+
+// blocking read of the first texel of `buffer`
+static void read_texel(_glblas_internal_context *context, _glblas_internal_buffer *buffer, float *texel)
+{
+    if (context->readback == 0) {
+        glGenBuffers(1, &context->readback);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, context->readback);
+        glBufferData(GL_PIXEL_PACK_BUFFER, FLOATS_PER_PIXEL * sizeof(float), NULL, GL_STREAM_READ);
+    }
+    else {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, context->readback);
+    }
+
+    state_bind_framebuffer(context, buffer->framebuffer);
+    glReadPixels(0, 0, 1, 1, GL_RGBA, GL_FLOAT, (void*)0);
+
+    const float *mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, FLOATS_PER_PIXEL * sizeof(float), GL_MAP_READ_BIT);
+    memcpy(texel, mapped, FLOATS_PER_PIXEL * sizeof(float));
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+// in host mode, read the pooled result texel back into `result`
+static void result_release(_glblas_internal_context *context, void *result, _glblas_internal_buffer *buffer)
+{
+    if (context->pointer_mode != GLBLAS_POINTER_MODE_HOST)
+        return;
+
+    float texel[FLOATS_PER_PIXEL];
+    read_texel(context, buffer, texel);
+    *(float*)result = texel[0];
+
+    scratch_release(buffer);
+}
+
+#define GLSL_FUSED \
+    "layout(std140) uniform Fused {\n" \
+    "    vec4 alpha[4];\n" \
+    "    ivec4 max_index[4];\n" \
+    "    int width;\n" \
+    "    int texels;\n" \
+    "} fused;\n" \
+    "bvec4 live(int t, int n)\n" \
+    "{\n" \
+    "    return lessThan(ivec4(t * 4) + ivec4(0, 1, 2, 3), ivec4(n));\n" \
+    "}\n" \
+    GLSL_FETCH
+
+// slot of `buffer` in the chain, adding it if there is room; -1 otherwise
+static int fusion_slot(_glblas_internal_fusion *fusion, _glblas_internal_buffer *buffer)
+{
+    for (int i = 0; i < fusion->n_buffers; i++) {
+        if (fusion->buffers[i] == buffer)
+            return i;
+    }
+
+    if (fusion->n_buffers == FUSE_MAX_BUFFERS)
+        return -1;
+
+    fusion->buffers[fusion->n_buffers] = buffer;
+    fusion->written[fusion->n_buffers] = false;
+
+    return fusion->n_buffers++;
+}
+
+#define APPEND(...) length += snprintf(src + length, size - length, __VA_ARGS__)
+
+// kernel for the recorded chain: only its shape is baked in, alphas and sizes come from the Fused block
+static void fusion_source(_glblas_internal_context *context, char *src, size_t size)
+{
+    _glblas_internal_fusion *fusion = &context->fusion;
+    bool compute = context->backend == GLBLAS_BACKEND_COMPUTE;
+    int length = 0;
+
+    APPEND("%s", compute ? "layout(local_size_x = 256) in;\n" : "");
+    APPEND("%s", GLSL_FUSED);
+
+    for (int i = 0, out = 0; i < fusion->n_buffers; i++) {
+        APPEND("uniform sampler2D x%d;\n", i);
+        if (!fusion->written[i])
+            continue;
+        if (compute)
+            APPEND("layout(rgba32f, binding = %d) uniform image2D out%d;\n", out++, i);
+        else
+            APPEND("layout(location = %d) out vec4 out%d;\n", out++, i);
+    }
+
+    APPEND("void main()\n{\n");
+    if (compute) {
+        APPEND("    int t = int(gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x) * 256 + int(gl_LocalInvocationID.x);\n");
+        APPEND("    if (t >= fused.texels) return;\n");
+    }
+    else {
+        APPEND("    int t = int(gl_FragCoord.y) * fused.width + int(gl_FragCoord.x);\n");
+    }
+
+    for (int i = 0; i < fusion->n_buffers; i++)
+        APPEND("    vec4 v%d = fetch4(x%d, t);\n", i, i);
+
+    for (int i = 0; i < fusion->n_ops; i++) {
+        const _glblas_internal_fused_op *op = &fusion->ops[i];
+        int y = op->y, x = op->x;
+
+        APPEND("    v%d = mix(v%d, ", y, y);
+        switch (op->kind) {
+        case FUSE_SCAL: APPEND("v%d * fused.alpha[%d][%d]", y, i / 4, i % 4); break;
+        case FUSE_COPY: APPEND("v%d", x); break;
+        case FUSE_AXPY: APPEND("v%d + fused.alpha[%d][%d] * v%d", y, i / 4, i % 4, x); break;
+        }
+        APPEND(", live(t, fused.max_index[%d][%d]));\n", i / 4, i % 4);
+    }
+
+    for (int i = 0; i < fusion->n_buffers; i++) {
+        if (!fusion->written[i])
+            continue;
+        if (compute)
+            APPEND("    imageStore(out%d, ivec2(t %% imageSize(out%d).x, t / imageSize(out%d).x), v%d);\n", i, i, i, i);
+        else
+            APPEND("    out%d = v%d;\n", i, i);
+    }
+
+    APPEND("}\n");
+}
+
+#undef APPEND
+
+static unsigned int fusion_program(_glblas_internal_context *context)
+{
+    _glblas_internal_fusion *fusion = &context->fusion;
+    bool compute = context->backend == GLBLAS_BACKEND_COMPUTE;
+    const char *header = compute ? "#version 430 core\n" : "#version 330 core\n";
+    char src[8192];
+
+    fusion_source(context, src, sizeof(src));
+    uint64_t hash = program_hash(context, header, src);
+
+    for (int i = 0; i < FUSE_PROGRAM_CACHE; i++) {
+        if (fusion->programs[i].program && fusion->programs[i].hash == hash)
+            return fusion->programs[i].program;
+    }
+
+    int slot = fusion->program_next;
+    fusion->program_next = (slot + 1) % FUSE_PROGRAM_CACHE;
+
+    if (fusion->programs[slot].program) {
+        if (context->state.program == fusion->programs[slot].program)
+            context->state.program = 0;
+        glDeleteProgram(fusion->programs[slot].program);
+    }
+
+    fusion->programs[slot].hash = hash;
+    fusion->programs[slot].program = load_program(context, compute, header, src);
+
+    return fusion->programs[slot].program;
+}
+
+// run the recorded chain as one pass and start a new one
+static void fusion_flush(_glblas_internal_context *context)
+{
+    _glblas_internal_fusion *fusion = &context->fusion;
+    _glblas_internal_fused_params *params = &fusion->params;
+
+    if (fusion->n_ops == 0)
+        return;
+
+    params->texels = 0;
+    for (int i = 0; i < fusion->n_ops; i++)
+        params->texels = MAX(params->texels, texel_count(params->max_index[i]));
+
+    state_use_program(context, fusion_program(context));
+
+    for (int i = 0; i < fusion->n_buffers; i++)
+        state_bind_texture(context, i, fusion->buffers[i]->texture_colorbuffer);
+
+    if (fusion->UBO == 0) {
+        glGenBuffers(1, &fusion->UBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, fusion->UBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(_glblas_internal_fused_params), NULL, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, FUSED_BINDING, fusion->UBO);
+    }
+
+    // upload_params relies on the params ubo being the one bound to GL_UNIFORM_BUFFER
+    glBindBuffer(GL_UNIFORM_BUFFER, fusion->UBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(_glblas_internal_fused_params), params);
+    glBindBuffer(GL_UNIFORM_BUFFER, context->UBO);
+
+    if (context->backend == GLBLAS_BACKEND_COMPUTE) {
+        for (int i = 0, out = 0; i < fusion->n_buffers; i++) {
+            if (fusion->written[i])
+                glBindImageTexture(out++, fusion->buffers[i]->texture_colorbuffer, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+        }
+        // only unit 0 is tracked
+        context->state.image = 0;
+
+        int groups = MAX(1, (params->texels + CS_GROUP_SIZE - 1) / CS_GROUP_SIZE);
+        int groups_x = MIN(groups, CS_MAX_GROUPS);
+        glDispatchCompute(groups_x, (groups + groups_x - 1) / groups_x, 1);
+        glMemoryBarrier(GL_ALL_BARRIER_BITS);
+    }
+    else {
+        _glblas_internal_buffer *targets[FUSE_MAX_BUFFERS];
+        int outputs = 0;
+
+        for (int i = 0; i < fusion->n_buffers; i++) {
+            if (fusion->written[i])
+                targets[outputs++] = fusion->buffers[i];
+        }
+
+        bind_targets(context, targets, outputs);
+        state_viewport(context, MIN(params->texels, params->width), (params->texels + params->width - 1) / params->width);
+        state_bind_vertex_array(context, context->VAO);
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        release_targets(context, outputs);
+    }
+
+    fusion->n_ops = 0;
+    fusion->n_buffers = 0;
+}
+
+// whether a call can be recorded instead of run
+static inline bool fusable(_glblas_internal_context *context, int N, const _glblas_internal_scalar *alpha, int incx, int incy)
+{
+    return context->execution_mode == GLBLAS_EXECUTION_DEFERRED && N > 0 && incx == 1 && incy == 1 && (alpha == NULL || alpha->buffer == NULL);
+}
+
+// append y = op(x, y) to the chain, flushing first if it doesn't fit
+static void fusion_record(_glblas_internal_context *context, _glblas_internal_fused_kind kind, int N, float alpha, _glblas_internal_buffer *x, _glblas_internal_buffer *y)
+{
+    _glblas_internal_fusion *fusion = &context->fusion;
+
+    // fragment outputs are attachments of one framebuffer, which only renders where they all overlap
+    bool layout_ok = context->backend == GLBLAS_BACKEND_COMPUTE || fusion->n_ops == 0 ||
+                     (y->width == fusion->params.width && y->height == fusion->height);
+
+    int slot_x = -1, slot_y = -1;
+    if (fusion->n_ops == FUSE_MAX_OPS || !layout_ok || (slot_y = fusion_slot(fusion, y)) < 0 || (x && (slot_x = fusion_slot(fusion, x)) < 0)) {
+        fusion_flush(context);
+        slot_y = fusion_slot(fusion, y);
+        slot_x = x ? fusion_slot(fusion, x) : -1;
+    }
+
+    if (fusion->n_ops == 0) {
+        fusion->params.width = y->width;
+        fusion->height = y->height;
+    }
+
+    fusion->written[slot_y] = true;
+    fusion->params.alpha[fusion->n_ops] = alpha;
+    fusion->params.max_index[fusion->n_ops] = N;
+    fusion->ops[fusion->n_ops++] = (_glblas_internal_fused_op){ .kind = kind, .x = slot_x, .y = slot_y };
+}
+
+glblasStatus_t glblasSetExecutionMode(glblasHandle_t ctx, glblasExecutionMode_t mode)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+
+    GLBLAS_ASSERT_STATUS(context, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(mode == GLBLAS_EXECUTION_IMMEDIATE || mode == GLBLAS_EXECUTION_DEFERRED, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    context->execution_mode = mode;
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+glblasStatus_t glblasGetExecutionMode(glblasHandle_t ctx, glblasExecutionMode_t *mode)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+
+    GLBLAS_ASSERT_STATUS(context && mode, GLBLAS_STATUS_INVALID_VALUE);
+
+    *mode = context->execution_mode;
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+glblasStatus_t glblasFlush(glblasHandle_t ctx)
+{
+    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
+
+    GLBLAS_ASSERT_STATUS(context, GLBLAS_STATUS_INVALID_VALUE);
+
+    // make_current does the flushing
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+// x = a*x
+// x *= alpha on a buffer, context already current
+static void scal_buffers(_glblas_internal_context *context, int N, _glblas_internal_scalar alpha, _glblas_internal_buffer *device_x, int incx)
+{
+    // x*1 is x, nothing to draw
+    int variant = scalar_variant(&alpha, NULL) | (incx == 1 ? VARIANT_UNIT_STRIDE : 0);
+    if (variant & VARIANT_ALPHA_ONE)
+        return;
+
+    _glblas_internal_params params = {
+        .alpha = alpha.value,
+        .scalar_mode = bind_scalars(context, &alpha, NULL),
+        .max_index = N,
+        .incx = incx,
+    };
+
+    if (context->backend == GLBLAS_BACKEND_COMPUTE) {
+        dispatch_linear(context, OP_CS_SSCAL, variant, device_x, elementwise_groups(N), &params);
+        return;
+    }
+
+    state_bind_texture(context, 0, device_x->texture_colorbuffer);
+    draw(context, OP_SSCAL, variant, device_x, texel_count(N), &params);
+}
+
+static glblasStatus_t glblas_sscal(int N, _glblas_internal_scalar alpha, glblasMemory_t x, int incx)
+{
+    _glblas_internal_buffer *device_x = get_buffer_from_handle(x);
+    GLBLAS_ASSERT_STATUS(device_x, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_context *context = device_x->context;
+
+    GLBLAS_ASSERT_STATUS(bind_context(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    if (scalar_variant(&alpha, NULL) & VARIANT_ALPHA_ONE)
+        return GLBLAS_STATUS_SUCCESS;
+
+    if (fusable(context, N, &alpha, incx, 1)) {
+        fusion_record(context, FUSE_SCAL, N, alpha.value, NULL, device_x);
+        return GLBLAS_STATUS_SUCCESS;
+    }
+    fusion_flush(context);
+
+    scal_buffers(context, N, alpha, device_x, incx);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+glblasStatus_t glblasSscal(int N, const float alpha, glblasMemory_t x, int incx)
+{
+    return glblas_sscal(N, (_glblas_internal_scalar){ .value = alpha }, x, incx);
+}
+
+glblasStatus_t glblasSscal_v2(int N, const float *alpha, glblasMemory_t x, int incx)
+{
+    _glblas_internal_buffer *device_x = get_buffer_from_handle(x);
+    GLBLAS_ASSERT_STATUS(device_x, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_scalar s_alpha;
+    glblasStatus_t status;
+    IF_NOT_SUCCESS_RETURN(get_scalar(device_x->context, alpha, &s_alpha));
+
+    return glblas_sscal(N, s_alpha, x, incx);
+}
+
+static glblasStatus_t glblas_scopy(int N, _glblas_internal_buffer *device_x, int incx, _glblas_internal_buffer *device_y, int incy)
+{
+    _glblas_internal_context *context = device_x->context;
+
+    int variant = incx == 1 && incy == 1 ? VARIANT_UNIT_STRIDE : 0;
+
+    _glblas_internal_params params = {
+        .max_index = N,
+        .incx = incx,
+        .incy = incy,
+    };
+
+    state_bind_texture(context, 0, device_x->texture_colorbuffer);
+
+    if (context->backend == GLBLAS_BACKEND_COMPUTE) {
+        dispatch_linear(context, OP_CS_SCOPY, variant, device_y, elementwise_groups(N), &params);
+        return GLBLAS_STATUS_SUCCESS;
+    }
+
+    state_bind_texture(context, 1, device_y->texture_colorbuffer);
+    draw(context, OP_SCOPY, variant, device_y, texel_count(N), &params);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+// copy x into y
+glblasStatus_t glblasScopy(int N, const glblasMemory_t x, int incx, glblasMemory_t y, int incy)
+{
+    _glblas_internal_buffer *device_x = get_buffer_from_handle(x);
+    _glblas_internal_buffer *device_y = get_buffer_from_handle(y);
+
+    GLBLAS_ASSERT_STATUS(device_x && device_y && device_x->context == device_y->context, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_context *context = device_x->context;
+
+    GLBLAS_ASSERT_STATUS(bind_context(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    if (fusable(context, N, NULL, incx, incy)) {
+        fusion_record(context, FUSE_COPY, N, 0.0f, device_x, device_y);
+        return GLBLAS_STATUS_SUCCESS;
+    }
+    fusion_flush(context);
+
+    // a contiguous copy is a plain device to device memcpy
+    if (incx == 1 && incy == 1 && N * sizeof(float) <= MIN(device_x->size, device_y->size)) {
+        copy_buffer(device_y, 0, device_x, 0, N * sizeof(float));
+        return GLBLAS_STATUS_SUCCESS;
+    }
+
+    return glblas_scopy(N, device_x, incx, device_y, incy);
+}
+
+// y = a*x + y
+// y += alpha*x on buffers, context already current
+static void axpy_buffers(_glblas_internal_context *context, int N, _glblas_internal_scalar alpha, _glblas_internal_buffer *device_x, int incx, _glblas_internal_buffer *device_y, int incy)
+{
+    int variant = scalar_variant(&alpha, NULL) | (incx == 1 && incy == 1 ? VARIANT_UNIT_STRIDE : 0);
+
+    _glblas_internal_params params = {
+        .alpha = alpha.value,
+        .scalar_mode = bind_scalars(context, &alpha, NULL),
+        .max_index = N,
+        .incx = incx,
+        .incy = incy,
+    };
+
+    state_bind_texture(context, 0, device_x->texture_colorbuffer);
+
+    if (context->backend == GLBLAS_BACKEND_COMPUTE) {
+        dispatch_linear(context, OP_CS_SAXPY, variant, device_y, elementwise_groups(N), &params);
+        return;
+    }
+
+    state_bind_texture(context, 1, device_y->texture_colorbuffer);
+    draw(context, OP_SAXPY, variant, device_y, texel_count(N), &params);
+}
+
+static glblasStatus_t glblas_saxpy(int N, _glblas_internal_scalar alpha, const glblasMemory_t x, int incx, glblasMemory_t y, int incy)
+{
+    _glblas_internal_buffer *device_x = get_buffer_from_handle(x);
+    _glblas_internal_buffer *device_y = get_buffer_from_handle(y);
+
+    GLBLAS_ASSERT_STATUS(device_x && device_y && device_x->context == device_y->context, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_context *context = device_x->context;
+
+    GLBLAS_ASSERT_STATUS(bind_context(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    if (fusable(context, N, &alpha, incx, incy)) {
+        fusion_record(context, FUSE_AXPY, N, alpha.value, device_x, device_y);
+        return GLBLAS_STATUS_SUCCESS;
+    }
+    fusion_flush(context);
+
+    axpy_buffers(context, N, alpha, device_x, incx, device_y, incy);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+glblasStatus_t glblasSaxpy(int N, const float alpha, const glblasMemory_t x, int incx, glblasMemory_t y, int incy)
+{
+    return glblas_saxpy(N, (_glblas_internal_scalar){ .value = alpha }, x, incx, y, incy);
+}
+
+glblasStatus_t glblasSaxpy_v2(int N, const float *alpha, const glblasMemory_t x, int incx, glblasMemory_t y, int incy)
+{
+    _glblas_internal_buffer *device_y = get_buffer_from_handle(y);
+    GLBLAS_ASSERT_STATUS(device_y, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_scalar s_alpha;
+    glblasStatus_t status;
+    IF_NOT_SUCCESS_RETURN(get_scalar(device_y->context, alpha, &s_alpha));
+
+    return glblas_saxpy(N, s_alpha, x, incx, y, incy);
+}
+
+/*
+ * kernels updating both x and y (srot, sswap): with equal strides on distinct
+ * buffers both are written by a single pass, as two render targets of one
+ * framebuffer or two image units, and every texel reads its x and y before
+ * writing either. otherwise the caller saves x in scratch and does one side
+ * at a time. N spans y, as in sdot.
+ */
+static inline bool pair_pass_ok(_glblas_internal_context *context, _glblas_internal_buffer *device_x, int incx, _glblas_internal_buffer *device_y, int incy)
+{
+    return device_x != device_y && incx == incy && (context->backend == GLBLAS_BACKEND_COMPUTE || device_x->width == device_y->width);
+}
+
+static void pair_pass(_glblas_internal_context *context, int op, int cs_op, _glblas_internal_buffer *device_x, _glblas_internal_buffer *device_y, _glblas_internal_params *params)
+{
+    int N = params->max_index;
+    int variant = params->incx == 1 ? VARIANT_UNIT_STRIDE : 0;
+
+    if (context->backend == GLBLAS_BACKEND_COMPUTE) {
+        // only image unit 0 is tracked
+        glBindImageTexture(1, device_y->texture_colorbuffer, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+        dispatch_linear(context, cs_op, variant, device_x, elementwise_groups(N), params);
+        return;
+    }
+
+    state_bind_texture(context, 0, device_x->texture_colorbuffer);
+    state_bind_texture(context, 1, device_y->texture_colorbuffer);
+    draw_pair(context, op, variant, device_x, device_y, texel_count(N), params);
+}
+
+// elements of x touched when N spans y
+static inline int pair_span_x(int N, int incx, int incy)
+{
+    return ((N + incy - 1) / incy - 1) * incx + 1;
+}
+
+// swap x & y
+glblasStatus_t glblasSswap(int N, glblasMemory_t x, int incx, glblasMemory_t y, int incy)
+{
+    _glblas_internal_buffer *device_x = get_buffer_from_handle(x);
+    _glblas_internal_buffer *device_y = get_buffer_from_handle(y);
+
+    GLBLAS_ASSERT_STATUS(device_x && device_y && device_x->context == device_y->context, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(incx > 0 && incy > 0, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_context *context = device_x->context;
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    if (N <= 0 || (device_x == device_y && incx == incy))
+        return GLBLAS_STATUS_SUCCESS;
+
+    if (pair_pass_ok(context, device_x, incx, device_y, incy)) {
+        _glblas_internal_params params = {
+            .max_index = N,
+            .incx = incx,
+            .incy = incy,
+        };
+        pair_pass(context, OP_SSWAP, OP_CS_SSWAP, device_x, device_y, &params);
+
+        return GLBLAS_STATUS_SUCCESS;
+    }
+
+    int span_x = pair_span_x(N, incx, incy);
+
+    _glblas_internal_buffer *temp = scratch_acquire(context, span_x * sizeof(float));
+    copy_buffer(temp, 0, device_x, 0, span_x * sizeof(float));
+
+    glblas_scopy(span_x, device_y, incy, device_x, incx); // copy y into x
+    glblas_scopy(N, temp, incx, device_y, incy); // copy x into y
+
+    scratch_release(temp);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+/*
+ * plane rotation by h = (h11, h21, h12, h22). the fallback rebuilds each side
+ * with sscal + saxpy, launched directly so deferred mode can't record some of
+ * the steps and run the rest. when x and y are the same buffer both are staged
+ * in scratch first and x is written last, as reference blas does.
+ */
+static glblasStatus_t glblas_srot(int N, glblasMemory_t x, int incx, glblasMemory_t y, int incy, const float h[4])
+{
+    _glblas_internal_buffer *device_x = get_buffer_from_handle(x);
+    _glblas_internal_buffer *device_y = get_buffer_from_handle(y);
+
+    GLBLAS_ASSERT_STATUS(device_x && device_y && device_x->context == device_y->context, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(incx > 0 && incy > 0, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_context *context = device_x->context;
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    if (N <= 0)
+        return GLBLAS_STATUS_SUCCESS;
+
+    if (pair_pass_ok(context, device_x, incx, device_y, incy)) {
+        _glblas_internal_params params = {
+            .max_index = N,
+            .incx = incx,
+            .incy = incy,
+            .rot = { h[0], h[1], h[2], h[3] },
+        };
+        pair_pass(context, OP_SROT, OP_CS_SROT, device_x, device_y, &params);
+
+        return GLBLAS_STATUS_SUCCESS;
+    }
+
+    int span_x = pair_span_x(N, incx, incy);
+
+    _glblas_internal_buffer *temp = scratch_acquire(context, span_x * sizeof(float));
+    copy_buffer(temp, 0, device_x, 0, span_x * sizeof(float));
+
+    if (device_x == device_y) {
+        _glblas_internal_buffer *temp_y = scratch_acquire(context, N * sizeof(float));
+        copy_buffer(temp_y, 0, device_y, 0, N * sizeof(float));
+
+        scal_buffers(context, N, (_glblas_internal_scalar){ .value = h[3] }, device_y, incy);
+        axpy_buffers(context, N, (_glblas_internal_scalar){ .value = h[1] }, temp, incx, device_y, incy);
+
+        glblas_scopy(span_x, temp, incx, device_x, incx);
+        scal_buffers(context, span_x, (_glblas_internal_scalar){ .value = h[0] }, device_x, incx);
+        axpy_buffers(context, span_x, (_glblas_internal_scalar){ .value = h[2] }, temp_y, incy, device_x, incx);
+
+        scratch_release(temp_y);
+        scratch_release(temp);
+
+        return GLBLAS_STATUS_SUCCESS;
+    }
+
+    scal_buffers(context, span_x, (_glblas_internal_scalar){ .value = h[0] }, device_x, incx);
+    axpy_buffers(context, span_x, (_glblas_internal_scalar){ .value = h[2] }, device_y, incy, device_x, incx);
+    scal_buffers(context, N, (_glblas_internal_scalar){ .value = h[3] }, device_y, incy);
+    axpy_buffers(context, N, (_glblas_internal_scalar){ .value = h[1] }, temp, incx, device_y, incy);
+
+    scratch_release(temp);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+// apply the givens rotation (c, s)
+glblasStatus_t glblasSrot(int N, glblasMemory_t x, int incx, glblasMemory_t y, int incy, const float c, const float s)
+{
+    const float h[4] = { c, -s, s, c };
+
+    return glblas_srot(N, x, incx, y, incy, h);
+}
+
+// apply the modified givens rotation in param (flag, h11, h21, h12, h22)
+glblasStatus_t glblasSrotm(int N, glblasMemory_t x, int incx, glblasMemory_t y, int incy, const float *param)
+{
+    GLBLAS_ASSERT_STATUS(param, GLBLAS_STATUS_INVALID_VALUE);
+
+    float h[4];
+
+    if (param[0] == -1.0f) {
+        h[0] = param[1]; h[1] = param[2]; h[2] = param[3]; h[3] = param[4];
+    }
+    else if (param[0] == 0.0f) {
+        h[0] = 1.0f; h[1] = param[2]; h[2] = param[3]; h[3] = 1.0f;
+    }
+    else if (param[0] == 1.0f) {
+        h[0] = param[1]; h[1] = -1.0f; h[2] = 1.0f; h[3] = param[4];
+    }
+    else {
+        GLBLAS_ASSERT_STATUS(param[0] == -2.0f, GLBLAS_STATUS_INVALID_VALUE);
+        // h is the identity
+        return GLBLAS_STATUS_SUCCESS;
+    }
+
+    return glblas_srot(N, x, incx, y, incy, h);
+}
+
+/*
+ * compute flavour of reduce: `first_op` folds 4096 elements per workgroup
+ * into one texel (the sum in .x), then each pass folds 1024 texels per group
+ * until a single group can finish into the result. log1024(N) dispatches.
+ */
+#define CS_REDUCE_FIRST (16 * CS_GROUP_SIZE)
+#define CS_REDUCE_FOLD (4 * CS_GROUP_SIZE)
+
+static void reduce_compute(int first_op, int final_op, int variant, int count, int max_index, _glblas_internal_buffer *device_x, int incx, _glblas_internal_buffer *device_y, int incy, _glblas_internal_buffer *device_result)
+{
+    _glblas_internal_context *context = device_x->context;
+
+    size_t texel_size = FLOATS_PER_PIXEL * sizeof(float);
+    int texels = MAX(1, (count + CS_REDUCE_FIRST - 1) / CS_REDUCE_FIRST);
+    int next = (texels + CS_REDUCE_FOLD - 1) / CS_REDUCE_FOLD;
+
+    _glblas_internal_buffer *src = scratch_acquire(context, texels * texel_size);
+    _glblas_internal_buffer *dst = next > 1 ? scratch_acquire(context, next * texel_size) : NULL;
+
+    state_bind_texture(context, 0, device_x->texture_colorbuffer);
+    if (device_y)
+        state_bind_texture(context, 1, device_y->texture_colorbuffer);
+
+    _glblas_internal_params params = {
+        .max_index = max_index,
+        .incx = incx,
+        .incy = incy,
+    };
+    dispatch_linear(context, first_op, variant, src, texels, &params);
+
+    for (; texels > CS_REDUCE_FOLD; texels = next, next = (texels + CS_REDUCE_FOLD - 1) / CS_REDUCE_FOLD) {
+        state_bind_texture(context, 0, src->texture_colorbuffer);
+        params = (_glblas_internal_params){ .max_index = texels };
+        dispatch_linear(context, OP_CS_REDUCE, 0, dst, next, &params);
+
+        _glblas_internal_buffer *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    state_bind_texture(context, 0, src->texture_colorbuffer);
+    params = (_glblas_internal_params){ .max_index = texels };
+    dispatch(context, final_op, 0, device_result, 1, 1, &params);
+
+    scratch_release(src);
+    if (dst)
+        scratch_release(dst);
+}
+
+/*
+ * sum reduction of `count` elements into the first float of device_result.
+ * `first_op` (OP_SDOT, OP_SASUM or OP_SNRM2) reads x (and y) and writes one
+ * texel of partial sums per 64 elements, then each pass folds 16 texels into
+ * one, ping-ponging between two scratch targets, until a single texel is left.
+ * the whole chain is queued without waiting on the gpu: o(N) fragment work in
+ * log16(N) passes.
+ */
+static void reduce(int first_op, int count, int max_index, _glblas_internal_buffer *device_x, int incx, _glblas_internal_buffer *device_y, int incy, _glblas_internal_buffer *device_result)
+{
+    _glblas_internal_context *context = device_x->context;
+    int variant = incx == 1 && incy == 1 ? VARIANT_UNIT_STRIDE : 0;
+
+    if (context->backend == GLBLAS_BACKEND_COMPUTE) {
+        int cs_first = first_op == OP_SDOT ? OP_CS_SDOT : first_op == OP_SASUM ? OP_CS_SASUM : OP_CS_SNRM2;
+        reduce_compute(cs_first, first_op == OP_SNRM2 ? OP_CS_SNRM2_FINAL : OP_CS_REDUCE_FINAL, variant, count, max_index, device_x, incx, device_y, incy, device_result);
+        return;
+    }
+
+    size_t texel_size = FLOATS_PER_PIXEL * sizeof(float);
+    int texels = MAX(1, (count + REDUCE_FOLD * FLOATS_PER_PIXEL - 1) / (REDUCE_FOLD * FLOATS_PER_PIXEL));
+    int next = (texels + REDUCE_FOLD - 1) / REDUCE_FOLD;
+
+    _glblas_internal_buffer *src = scratch_acquire(context, texels * texel_size);
+    _glblas_internal_buffer *dst = texels > 1 ? scratch_acquire(context, next * texel_size) : NULL;
+
+    // bind after acquiring, creating scratch storage rebinds the active unit
+    state_bind_texture(context, 0, device_x->texture_colorbuffer);
+    if (device_y)
+        state_bind_texture(context, 1, device_y->texture_colorbuffer);
+
+    _glblas_internal_params params = {
+        .max_index = max_index,
+        .incx = incx,
+        .incy = incy,
+    };
+    draw(context, first_op, variant, src, texels, &params);
+
+    for (; texels > 1; texels = next, next = (texels + REDUCE_FOLD - 1) / REDUCE_FOLD) {
+        state_bind_texture(context, 0, src->texture_colorbuffer);
+        params = (_glblas_internal_params){ .max_index = texels };
+        draw(context, OP_REDUCE, 0, dst, next, &params);
+
+        _glblas_internal_buffer *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    // only the first float of the result is written
+    state_bind_texture(context, 0, src->texture_colorbuffer);
+    glColorMask(GL_TRUE, GL_FALSE, GL_FALSE, GL_FALSE);
+    params = (_glblas_internal_params){ .max_index = 1 };
+    draw(context, first_op == OP_SNRM2 ? OP_SNRM2_FINAL : OP_REDUCE_FINAL, 0, device_result, 1, &params);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+    scratch_release(src);
+    if (dst)
+        scratch_release(dst);
+}
+
+// dot product
+glblasStatus_t glblasSdot(int N, glblasMemory_t result, const glblasMemory_t x, int incx, const glblasMemory_t y, int incy)
+{
+    _glblas_internal_buffer *device_x = get_buffer_from_handle(x);
+    _glblas_internal_buffer *device_y = get_buffer_from_handle(y);
+
+    GLBLAS_ASSERT_STATUS(device_x && device_y && device_x->context == device_y->context, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(incx > 0 && incy > 0, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_context *context = device_x->context;
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    _glblas_internal_buffer *device_result = result_acquire(context, result);
+    GLBLAS_ASSERT_STATUS(device_result, GLBLAS_STATUS_INVALID_VALUE);
+
+    // N spans y, like the other strided kernels
+    reduce(OP_SDOT, (MAX(N, 0) + incy - 1) / incy, N, device_x, incx, device_y, incy, device_result);
+    result_release(context, result, device_result);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+// sum of abs values
+glblasStatus_t glblasSasum(int N, glblasMemory_t result, const glblasMemory_t x, int incx)
+{
+    _glblas_internal_buffer *device_x = get_buffer_from_handle(x);
+
+    GLBLAS_ASSERT_STATUS(device_x, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(incx > 0, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_context *context = device_x->context;
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    _glblas_internal_buffer *device_result = result_acquire(context, result);
+    GLBLAS_ASSERT_STATUS(device_result, GLBLAS_STATUS_INVALID_VALUE);
+
+    reduce(OP_SASUM, (MAX(N, 0) + incx - 1) / incx, N, device_x, incx, NULL, incx, device_result);
+    result_release(context, result, device_result);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+// euclidean norm, scaled so it neither over- nor underflows
+glblasStatus_t glblasSnrm2(int N, glblasMemory_t result, const glblasMemory_t x, int incx)
+{
+    _glblas_internal_buffer *device_x = get_buffer_from_handle(x);
+
+    GLBLAS_ASSERT_STATUS(device_x, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(incx > 0, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_context *context = device_x->context;
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    _glblas_internal_buffer *device_result = result_acquire(context, result);
+    GLBLAS_ASSERT_STATUS(device_result, GLBLAS_STATUS_INVALID_VALUE);
+
+    reduce(OP_SNRM2, (MAX(N, 0) + incx - 1) / incx, N, device_x, incx, NULL, incx, device_result);
+    result_release(context, result, device_result);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+/*
+ * isamax/isamin: the same pass structure as reduce, folding candidates rather
+ * than sums down to a single texel of scratch. host mode reads the index from
+ * that texel directly, device mode converts it into the result's first float.
+ */
+static glblasStatus_t glblas_isamax(int N, void *result, const glblasMemory_t x, int incx, int variant)
+{
+    _glblas_internal_buffer *device_x = get_buffer_from_handle(x);
+
+    GLBLAS_ASSERT_STATUS(device_x, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(incx > 0, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_context *context = device_x->context;
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    _glblas_internal_buffer *device_result = NULL;
+    if (context->pointer_mode == GLBLAS_POINTER_MODE_HOST) {
+        GLBLAS_ASSERT_STATUS(result, GLBLAS_STATUS_INVALID_VALUE);
+    }
+    else {
+        device_result = get_buffer_from_handle(result);
+        GLBLAS_ASSERT_STATUS(device_result && device_result->context == context, GLBLAS_STATUS_INVALID_VALUE);
+    }
+
+    bool compute = context->backend == GLBLAS_BACKEND_COMPUTE;
+    int first = compute ? CS_REDUCE_FIRST : REDUCE_FOLD * FLOATS_PER_PIXEL;
+    int fold = compute ? CS_REDUCE_FOLD : REDUCE_FOLD;
+
+    // N spans x, like sasum
+    int count = (MAX(N, 0) + incx - 1) / incx;
+    size_t texel_size = FLOATS_PER_PIXEL * sizeof(float);
+    int texels = MAX(1, (count + first - 1) / first);
+    int next = (texels + fold - 1) / fold;
+
+    _glblas_internal_buffer *src = scratch_acquire(context, texels * texel_size);
+    _glblas_internal_buffer *dst = texels > 1 ? scratch_acquire(context, next * texel_size) : NULL;
+
+    state_bind_texture(context, 0, device_x->texture_colorbuffer);
+
+    variant |= incx == 1 ? VARIANT_UNIT_STRIDE : 0;
+    _glblas_internal_params params = {
+        .max_index = N,
+        .incx = incx,
+    };
+    if (compute)
+        dispatch_linear(context, OP_CS_ISAMAX, variant, src, texels, &params);
+    else
+        draw(context, OP_ISAMAX, variant, src, texels, &params);
+
+    variant &= VARIANT_ARGMIN;
+    for (; texels > 1; texels = next, next = (texels + fold - 1) / fold) {
+        state_bind_texture(context, 0, src->texture_colorbuffer);
+        params = (_glblas_internal_params){ .max_index = texels };
+        if (compute)
+            dispatch_linear(context, OP_CS_ISAMAX_REDUCE, variant, dst, next, &params);
+        else
+            draw(context, OP_ISAMAX_REDUCE, variant, dst, next, &params);
+
+        _glblas_internal_buffer *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (device_result) {
+        state_bind_texture(context, 0, src->texture_colorbuffer);
+        params = (_glblas_internal_params){ .max_index = 1 };
+        if (compute) {
+            dispatch(context, OP_CS_ISAMAX_FINAL, 0, device_result, 1, 1, &params);
+        }
+        else {
+            glColorMask(GL_TRUE, GL_FALSE, GL_FALSE, GL_FALSE);
+            draw(context, OP_ISAMAX_FINAL, 0, device_result, 1, &params);
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        }
+    }
+    else {
+        float texel[FLOATS_PER_PIXEL];
+        read_texel(context, src, texel);
+        *(int*)result = texel[1] < 0.0f ? 0 : (int)texel[1] * 4096 + (int)texel[2] + 1;
+    }
+
+    scratch_release(src);
+    if (dst)
+        scratch_release(dst);
+
+    return GLBLAS_STATUS_SUCCESS;
+}
+
+// index of max abs value
+glblasStatus_t glblasIsamax(int N, glblasMemory_t result, const glblasMemory_t x, int incx)
+{
+    return glblas_isamax(N, result, x, incx, 0);
+}
+
+// index of min abs value
+glblasStatus_t glblasIsamin(int N, glblasMemory_t result, const glblasMemory_t x, int incx)
+{
+    return glblas_isamax(N, result, x, incx, VARIANT_ARGMIN);
+}
+
+/*
+ * a short y over a long inner dimension leaves most of the gpu idle, so the
+ * inner dimension is split into ranges of at least GEMV_SPLIT_MIN elements
+ * until about GEMV_SPLIT_TEXELS partial texels are in flight; a second pass
+ * sums the partials into y.
+ */
+#define GEMV_SPLIT_TEXELS 16384
+#define GEMV_SPLIT_MIN 256
+
+// matrix vector multiply, a is M by N
+static glblasStatus_t glblas_sgemv( glblasOperation_t trans, int M, int N, _glblas_internal_scalar alpha
+                                  , const glblasMemory_t a, const int lda
+                                  , const glblasMemory_t x, int incx, _glblas_internal_scalar beta
+                                  , glblasMemory_t y, int incy )
+{
+    GLBLAS_ASSERT_STATUS(M >= 0 && N >= 0 && incx > 0 && incy > 0, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(lda >= MAX(1, M), GLBLAS_STATUS_DIMENSION_OVERFLOW);
+
+    _glblas_internal_buffer *device_a = get_buffer_from_handle(a);
+    _glblas_internal_buffer *device_x = get_buffer_from_handle(x);
+    _glblas_internal_buffer *device_y = get_buffer_from_handle(y);
+
+    GLBLAS_ASSERT_STATUS(device_a && device_x && device_y, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(device_a->context == device_y->context && device_x->context == device_y->context, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_context *context = device_y->context;
+
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    int rows = trans ? N : M;
+    int inner = trans ? M : N;
+
+    if (rows == 0)
         return GLBLAS_STATUS_SUCCESS;
-    }
 
-    // otherwise, (max_width, variable height)
-    *out_width = max_width;
-    *out_height = (count + max_width - 1) / max_width;
-    
-    return (*out_width <= max_width && *out_height <= max_height) ? GLBLAS_STATUS_SUCCESS : GLBLAS_STATUS_DIMENSION_OVERFLOW;
-}
+    bool compute = context->backend == GLBLAS_BACKEND_COMPUTE;
+    int texels = texel_count((rows - 1) * incy + 1);
 
-glblasMemory_t glblasMalloc(glblasHandle_t ctx, size_t size)
-{
-    _glblas_internal_context *context = (_glblas_internal_context*)ctx;
-    _glblas_internal_buffer *buf = dynarr_alloc((void**)&buffers, 0, sizeof(_glblas_internal_buffer));
+    int splits = 1, range = inner;
+    if (texels < GEMV_SPLIT_TEXELS && inner >= 2 * GEMV_SPLIT_MIN) {
+        splits = MIN((GEMV_SPLIT_TEXELS + texels - 1) / texels, inner / GEMV_SPLIT_MIN);
+        // ranges start on an x texel
+        range = ((inner + splits - 1) / splits + FLOATS_PER_PIXEL - 1) / FLOATS_PER_PIXEL * FLOATS_PER_PIXEL;
+        splits = (inner + range - 1) / range;
+    }
 
-    GLBLAS_ASSERT(size <= context->pbuffer_width * context->pbuffer_height * sizeof(float) * FLOATS_PER_PIXEL, "size (%ld) is out of bounds (max = %ld)\n", size, context->pbuffer_width * context->pbuffer_height * sizeof(float) * FLOATS_PER_PIXEL);
+    // acquire before binding, creating scratch storage rebinds the active unit
+    _glblas_internal_buffer *partial = splits > 1 ? scratch_acquire(context, (size_t)texels * splits * FLOATS_PER_PIXEL * sizeof(float)) : NULL;
+
+    int unit_stride = incx == 1 && incy == 1 && lda % FLOATS_PER_PIXEL == 0 ? VARIANT_UNIT_STRIDE : 0;
+    int variant = scalar_variant(&alpha, &beta) | (trans ? VARIANT_A_TRANS : 0) | unit_stride;
+
+    _glblas_internal_params params = {
+        .max_index = (rows - 1) * incy + 1,
+        .m = rows,
+        .n = splits,
+        .k = inner,
+        .lda = lda,
+        .ldb = range,
+        .incx = incx,
+        .incy = incy,
+        .alpha = alpha.value,
+        .beta = beta.value,
+        .scalar_mode = bind_scalars(context, &alpha, &beta),
+    };
 
-    buf->size = size;
-    get_texture_dimensions(size, context->pbuffer_width, context->pbuffer_height, &buf->width, &buf->height, &buf->is_padded);
+    state_bind_texture(context, 0, device_a->texture_colorbuffer);
+    state_bind_texture(context, 1, device_x->texture_colorbuffer);
 
-    glGenFramebuffers(1, &buf->framebuffer);
-    glGenTextures(1, &buf->texture_colorbuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, buf->framebuffer);
-    glBindTexture(GL_TEXTURE_2D, buf->texture_colorbuffer);
+    if (partial == NULL) {
+        if (compute) {
+            dispatch_linear(context, OP_CS_SGEMV, variant, device_y, (texels + CS_GROUP_SIZE - 1) / CS_GROUP_SIZE, &params);
+        }
+        else {
+            state_bind_texture(context, 2, device_y->texture_colorbuffer);
+            draw(context, OP_SGEMV, variant, device_y, texels, &params);
+        }
+        return GLBLAS_STATUS_SUCCESS;
+    }
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, buf->width, buf->height, 0, GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // GL_LINEAR changes the values, so use nearest
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, buf->texture_colorbuffer, 0);
+    int partial_variant = variant & (VARIANT_A_TRANS | VARIANT_UNIT_STRIDE);
+    if (compute)
+        dispatch_linear(context, OP_CS_SGEMV_PARTIAL, partial_variant, partial, (texels * splits + CS_GROUP_SIZE - 1) / CS_GROUP_SIZE, &params);
+    else
+        draw(context, OP_SGEMV_PARTIAL, partial_variant, partial, texels * splits, &params);
+
+    // the sum pass only needs y's stride
+    int sum_variant = scalar_variant(&alpha, &beta) | (incy == 1 ? VARIANT_UNIT_STRIDE : 0);
+    state_bind_texture(context, 0, partial->texture_colorbuffer);
+    if (compute) {
+        dispatch_linear(context, OP_CS_SGEMV_SUM, sum_variant, device_y, (texels + CS_GROUP_SIZE - 1) / CS_GROUP_SIZE, &params);
+    }
+    else {
+        state_bind_texture(context, 2, device_y->texture_colorbuffer);
+        draw(context, OP_SGEMV_SUM, sum_variant, device_y, texels, &params);
+    }
 
-    buf->context = context;
+    scratch_release(partial);
 
-    return (glblasMemory_t)buf;
+    return GLBLAS_STATUS_SUCCESS;
 }
 
-static inline _glblas_internal_buffer *get_buffer_from_address(size_t addr)
+glblasStatus_t glblasSgemv( glblasOperation_t trans, int M, int N, const float alpha
+                          , const glblasMemory_t a, const int lda
+                          , const glblasMemory_t x, int incx, const float beta
+                          , glblasMemory_t y, int incy )
 {
-    for (_glblas_internal_buffer *buf = buffers; buf; buf = buf->next) {
-        if (addr == (size_t)buf)
-            return buf;
-    }
-    return NULL;
+    return glblas_sgemv(trans, M, N, (_glblas_internal_scalar){ .value = alpha }, a, lda, x, incx, (_glblas_internal_scalar){ .value = beta }, y, incy);
 }
 
-glblasStatus_t glblasMemcpy(void *dst, void *src, size_t size, glblasMemcpyKind_t kind)
+glblasStatus_t glblasSgemv_v2( glblasOperation_t trans, int M, int N, const float *alpha
+                             , const glblasMemory_t a, const int lda
+                             , const glblasMemory_t x, int incx, const float *beta
+                             , glblasMemory_t y, int incy )
 {
-    _glblas_internal_buffer *buf_dst = get_buffer_from_address((size_t)dst);
-    _glblas_internal_buffer *buf_src = get_buffer_from_address((size_t)src);
+    _glblas_internal_buffer *device_y = get_buffer_from_handle(y);
+    GLBLAS_ASSERT_STATUS(device_y, GLBLAS_STATUS_INVALID_VALUE);
 
-    _glblas_internal_buffer *buf;
+    _glblas_internal_scalar s_alpha, s_beta;
+    glblasStatus_t status;
+    IF_NOT_SUCCESS_RETURN(get_scalar(device_y->context, alpha, &s_alpha));
+    IF_NOT_SUCCESS_RETURN(get_scalar(device_y->context, beta, &s_beta));
 
-    if (kind == glblasMemcpyInfer) {
-        // GLBLAS_ASSERT(buf_dst != NULL || buf_src != NULL, "invalid addresses (%p) (%p)\n", buf_dst, buf_src);
-        GLBLAS_ASSERT_STATUS(buf_dst != NULL || buf_src != NULL, GLBLAS_STATUS_INVALID_VALUE);
+    return glblas_sgemv(trans, M, N, s_alpha, a, lda, x, incx, s_beta, y, incy);
+}
 
-        if (buf_dst && buf_src)
-            kind = glblasMemcpyDeviceToDevice;
-        else if (buf_dst == NULL)
-            kind = glblasMemcpyDeviceToHost;
-        else
-            kind = glblasMemcpyHostToDevice;
-    }
+// rank-1 update, a is M by N
+static glblasStatus_t glblas_sger( int M, int N, _glblas_internal_scalar alpha
+                                 , const glblasMemory_t x, int incx
+                                 , const glblasMemory_t y, int incy
+                                 , glblasMemory_t a, const int lda )
+{
+    GLBLAS_ASSERT_STATUS(M >= 0 && N >= 0 && incx > 0 && incy > 0, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(lda >= MAX(1, M), GLBLAS_STATUS_DIMENSION_OVERFLOW);
 
-    switch (kind) {
-    case glblasMemcpyHostToDevice:
-        buf = buf_dst;
-        break;
-    case glblasMemcpyDeviceToHost:
-        buf = buf_src;
-        break;
-    case glblasMemcpyDeviceToDevice:
-        // GLBLAS_ASSERT(false, "prefer glblasScopy over glblasMemcpyDeviceToDevice\n");
-        // buf = buf_dst;
-        // break;
-        return GLBLAS_STATUS_NOT_SUPPORTED;
-    default:
-        break;
-    }
+    _glblas_internal_buffer *device_x = get_buffer_from_handle(x);
+    _glblas_internal_buffer *device_y = get_buffer_from_handle(y);
+    _glblas_internal_buffer *device_a = get_buffer_from_handle(a);
 
-    // GLBLAS_ASSERT(buf, "invalid buffer\n");
-    // GLBLAS_ASSERT(size <= buf->size, "size (%ld) is likely too large, buffer size is %ld\n", size, buf->size);
+    GLBLAS_ASSERT_STATUS(device_x && device_y && device_a, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(device_x->context == device_a->context && device_y->context == device_a->context, GLBLAS_STATUS_INVALID_VALUE);
 
-    GLBLAS_ASSERT_STATUS(buf && size <= buf->size, GLBLAS_STATUS_INVALID_VALUE);
+    _glblas_internal_context *context = device_a->context;
 
-    _glblas_internal_context *context = buf->context;
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
 
-    switch (kind) {
-    case glblasMemcpyHostToDevice:
-        if (buf->is_padded || buf->size != size) {
-            memcpy(context->pbuffer_host, src, size);
-            glBindTexture(GL_TEXTURE_2D, buf->texture_colorbuffer);
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, buf->width, buf->height, GL_RGBA, GL_FLOAT, context->pbuffer_host);
-        }
-        else {
-            glBindTexture(GL_TEXTURE_2D, buf->texture_colorbuffer);
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, buf->width, buf->height, GL_RGBA, GL_FLOAT, src);
-        }
-        break;
+    if (M == 0 || N == 0)
+        return GLBLAS_STATUS_SUCCESS;
 
-    case glblasMemcpyDeviceToHost:
-        if (buf->is_padded || buf->size != size) {
-            glBindFramebuffer(GL_FRAMEBUFFER, buf->framebuffer);
-            glReadPixels(0, 0, buf->width, buf->height, GL_RGBA, GL_FLOAT, context->pbuffer_host);
-            memcpy(dst, context->pbuffer_host, size);
-        }
-        else {
-            glBindFramebuffer(GL_FRAMEBUFFER, buf->framebuffer);
-            glReadPixels(0, 0, buf->width, buf->height, GL_RGBA, GL_FLOAT, dst);
-        }
-        break;
+    int unit_stride = incx == 1 && lda % FLOATS_PER_PIXEL == 0 ? VARIANT_UNIT_STRIDE : 0;
+    int variant = scalar_variant(&alpha, NULL) | unit_stride;
+    int max_index = (N - 1) * lda + M;
+
+    _glblas_internal_params params = {
+        .max_index = max_index,
+        .m = M,
+        .lda = lda,
+        .incx = incx,
+        .incy = incy,
+        .alpha = alpha.value,
+        .scalar_mode = bind_scalars(context, &alpha, NULL),
+    };
 
-    case glblasMemcpyDeviceToDevice:
-        glblasMemcpy(context->pbuffer_host, src, buf->size, glblasMemcpyDeviceToHost);
-        glblasMemcpy(dst, context->pbuffer_host, buf->size, glblasMemcpyHostToDevice);
-        break;
+    state_bind_texture(context, 0, device_x->texture_colorbuffer);
+    state_bind_texture(context, 1, device_y->texture_colorbuffer);
 
-    default:
-        break;
+    if (context->backend == GLBLAS_BACKEND_COMPUTE) {
+        dispatch_linear(context, OP_CS_SGER, variant, device_a, elementwise_groups(max_index), &params);
+    }
+    else {
+        state_bind_texture(context, 2, device_a->texture_colorbuffer);
+        draw(context, OP_SGER, variant, device_a, texel_count(max_index), &params);
     }
 
     return GLBLAS_STATUS_SUCCESS;
 }
 
-void glblasFree(glblasMemory_t buf)
+glblasStatus_t glblasSger( int M, int N, const float alpha
+                         , const glblasMemory_t x, int incx
+                         , const glblasMemory_t y, int incy
+                         , glblasMemory_t a, const int lda )
 {
-    _glblas_internal_buffer *buffer = (_glblas_internal_buffer*)buf;
-    
-    glDeleteFramebuffers(1, &buffer->framebuffer);
-    glDeleteTextures(1, &buffer->texture_colorbuffer);
-
-    dynarr_free_element((void**)&buffers, 0, buf);
+    return glblas_sger(M, N, (_glblas_internal_scalar){ .value = alpha }, x, incx, y, incy, a, lda);
 }
 
-// swap x & y
-glblasStatus_t glblasSswap(int N, glblasMemory_t x, int incx, glblasMemory_t y, int incy)
+glblasStatus_t glblasSger_v2( int M, int N, const float *alpha
+                            , const glblasMemory_t x, int incx
+                            , const glblasMemory_t y, int incy
+                            , glblasMemory_t a, const int lda )
 {
-    // infer context from x
-    glblasMemory_t temp = glblasMalloc(((_glblas_internal_buffer*)x)->context, N * sizeof(float));
-    glblasScopy(N, x, 1, temp, 1);
+    _glblas_internal_buffer *device_a = get_buffer_from_handle(a);
+    GLBLAS_ASSERT_STATUS(device_a, GLBLAS_STATUS_INVALID_VALUE);
 
-    glblasScopy(N, y, incy, x, incx); // copy y into x
-    glblasScopy(N, temp, incx, y, incy); // copy x into y
-
-    glblasFree(temp);
+    _glblas_internal_scalar s_alpha;
+    glblasStatus_t status;
+    IF_NOT_SUCCESS_RETURN(get_scalar(device_a->context, alpha, &s_alpha));
 
-    return GLBLAS_STATUS_SUCCESS;
+    return glblas_sger(M, N, s_alpha, x, incx, y, incy, a, lda);
 }
 
-static glblasStatus_t get_op_dims(const size_t N, _glblas_internal_buffer *dev, _glblas_internal_context *context, int *width, int *height)
+/*
+ * c = alpha*op(a)*op(b) + beta*c for `batch` problems stridea/b/c floats
+ * apart on buffers, the first starting offa/offb/offc floats in; context
+ * already current. one draw covers the whole batch, the compute tile takes
+ * the problem from the z of the dispatch, CS_MAX_GROUPS problems at a time.
+ */
+static void sgemm_batched_buffers( _glblas_internal_context *context, glblasOperation_t transa, glblasOperation_t transb
+                                 , int M, int N, int K, _glblas_internal_scalar alpha
+                                 , _glblas_internal_buffer *device_a, int offa, int lda, int stridea
+                                 , _glblas_internal_buffer *device_b, int offb, int ldb, int strideb, _glblas_internal_scalar beta
+                                 , _glblas_internal_buffer *device_c, int offc, int ldc, int stridec, int batch )
 {
-    if (N == dev->size / sizeof(float)) {
-        *width = dev->width;
-        *height = dev->height;
+    int variant = scalar_variant(&alpha, &beta) | (transa ? VARIANT_A_TRANS : 0) | (transb ? VARIANT_B_TRANS : 0);
+
+    // a single problem still divides by stridec, its a and b strides are never used
+    if (batch == 1) {
+        stridea = strideb = 0;
+        stridec = ldc * N;
     }
-    else {
-        get_texture_dimensions(N * sizeof(float), context->pbuffer_width, context->pbuffer_height, width, height, NULL);
+
+    _glblas_internal_params params = {
+        .m = M,
+        .n = N,
+        .k = K,
+        .lda = lda,
+        .ldb = ldb,
+        .ldc = ldc,
+        .offa = offa,
+        .offb = offb,
+        .offc = offc,
+        .stridea = stridea,
+        .strideb = strideb,
+        .stridec = stridec,
+        .batch = batch,
+        .alpha = alpha.value,
+        .beta = beta.value,
+        .scalar_mode = bind_scalars(context, &alpha, &beta),
+    };
+
+    state_bind_texture(context, 0, device_a->texture_colorbuffer);
+    state_bind_texture(context, 1, device_b->texture_colorbuffer);
+
+    // the tiled kernel writes whole texels of c, so columns must start on a texel
+    bool texel_columns = ldc % FLOATS_PER_PIXEL == 0 && offc % FLOATS_PER_PIXEL == 0 && stridec % FLOATS_PER_PIXEL == 0;
+
+    if (context->backend == GLBLAS_BACKEND_COMPUTE && texel_columns) {
+        for (int p = 0; p < batch; p += CS_MAX_GROUPS) {
+            params.offa = offa + p * stridea;
+            params.offb = offb + p * strideb;
+            params.offc = offc + p * stridec;
+            dispatch_3d(context, OP_CS_SGEMM, variant, device_c, (N + CS_SGEMM_TILE_N - 1) / CS_SGEMM_TILE_N, (M + CS_SGEMM_TILE_M - 1) / CS_SGEMM_TILE_M, MIN(batch - p, CS_MAX_GROUPS), &params);
+        }
+        return;
     }
 
-    return GLBLAS_STATUS_SUCCESS;
+    if (texel_columns)
+        variant |= VARIANT_UNIT_STRIDE;
+
+    // the fragment kernel covers all of c's columns, padding rows included
+    state_bind_texture(context, 2, device_c->texture_colorbuffer);
+    draw(context, OP_SGEMM, variant, device_c, texel_count(offc + (batch - 1) * stridec + ldc * N), &params);
 }
 
-// x = a*x
-glblasStatus_t glblasSscal(int N, const float alpha, glblasMemory_t x, int incx)
+// c = alpha*op(a)*op(b) + beta*c on buffers, the matrices start offa/offb/offc floats in; context already current
+static void sgemm_buffers( _glblas_internal_context *context, glblasOperation_t transa, glblasOperation_t transb
+                         , int M, int N, int K, _glblas_internal_scalar alpha
+                         , _glblas_internal_buffer *device_a, int offa, int lda
+                         , _glblas_internal_buffer *device_b, int offb, int ldb, _glblas_internal_scalar beta
+                         , _glblas_internal_buffer *device_c, int offc, int ldc )
 {
-    _glblas_internal_buffer *device_x = (_glblas_internal_buffer*)x;
-    _glblas_internal_context *context = device_x->context;
-    glblasStatus_t status;
+    sgemm_batched_buffers(context, transa, transb, M, N, K, alpha, device_a, offa, lda, 0, device_b, offb, ldb, 0, beta, device_c, offc, ldc, 0, 1);
+}
 
-    int width, height;
-    IF_NOT_SUCCESS_RETURN(get_op_dims(N, device_x, context, &width, &height));
+// matrix matrix multiply
+static glblasStatus_t glblas_sgemm( glblasOperation_t transa, glblasOperation_t transb
+                                  , int M, int N, int K, _glblas_internal_scalar alpha
+                                  , const glblasMemory_t a, const int lda
+                                  , const glblasMemory_t b, const int ldb, _glblas_internal_scalar beta
+                                  , glblasMemory_t c, const int ldc )
+{
+    // GLBLAS_ASSERT(M >= 0 && N >= 0 && K >= 0, "M, N, K must be 0 or positive\n"); // lol
+    // GLBLAS_ASSERT(lda >= MAX(1, transa ? K : M), "lda out of range\n");
+    // GLBLAS_ASSERT(ldb >= MAX(1, transb ? N : K), "ldb out of range\n");
+    // GLBLAS_ASSERT(ldc >= MAX(1, M), "ldc out of range\n");
 
-    glViewport(0, 0, width, height);
-    glUseProgram(shaders[OP_SSCAL].program);
+    GLBLAS_ASSERT_STATUS(M >= 0 && N >= 0 && K >= 0, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(lda >= MAX(1, transa ? K : M) && ldb >= MAX(1, transb ? N : K) && ldc >= MAX(1, M), GLBLAS_STATUS_DIMENSION_OVERFLOW);
+
+    _glblas_internal_buffer *device_a = get_buffer_from_handle(a);
+    _glblas_internal_buffer *device_b = get_buffer_from_handle(b);
+    _glblas_internal_buffer *device_c = get_buffer_from_handle(c);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, device_x->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SSCAL].program, "x"), 0);
+    GLBLAS_ASSERT_STATUS(device_a && device_b && device_c, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(device_a->context == device_c->context && device_b->context == device_c->context, GLBLAS_STATUS_INVALID_VALUE);
 
-    glUniform1f(glGetUniformLocation(shaders[OP_SSCAL].program, "alpha"), alpha);
+    _glblas_internal_context *context = device_c->context;
 
-    glUniform2f(glGetUniformLocation(shaders[OP_SSCAL].program, "dims"), width, height);
-    glUniform1i(glGetUniformLocation(shaders[OP_SSCAL].program, "max_index"), N);
-    glUniform1i(glGetUniformLocation(shaders[OP_SSCAL].program, "incx"), incx);
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, device_x->framebuffer);
-    glBindVertexArray(context->VAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    if (M == 0 || N == 0)
+        return GLBLAS_STATUS_SUCCESS;
+
+    sgemm_buffers(context, transa, transb, M, N, K, alpha, device_a, 0, lda, device_b, 0, ldb, beta, device_c, 0, ldc);
 
     return GLBLAS_STATUS_SUCCESS;
 }
 
-// copy x into y
-glblasStatus_t glblasScopy(int N, const glblasMemory_t x, int incx, glblasMemory_t y, int incy)
+glblasStatus_t glblasSgemm( glblasOperation_t transa, glblasOperation_t transb
+                          , int M, int N, int K, const float alpha
+                          , const glblasMemory_t a, const int lda
+                          , const glblasMemory_t b, const int ldb, const float beta
+                          , glblasMemory_t c, const int ldc )
 {
-    _glblas_internal_buffer *device_x = (_glblas_internal_buffer*)x;
-    _glblas_internal_buffer *device_y = (_glblas_internal_buffer*)y;
-    _glblas_internal_context *context = device_x->context;
-    glblasStatus_t status;
+    return glblas_sgemm(transa, transb, M, N, K, (_glblas_internal_scalar){ .value = alpha }, a, lda, b, ldb, (_glblas_internal_scalar){ .value = beta }, c, ldc);
+}
 
-    int width, height;
-    IF_NOT_SUCCESS_RETURN(get_op_dims(N, device_y, context, &width, &height));
+glblasStatus_t glblasSgemm_v2( glblasOperation_t transa, glblasOperation_t transb
+                             , int M, int N, int K, const float *alpha
+                             , const glblasMemory_t a, const int lda
+                             , const glblasMemory_t b, const int ldb, const float *beta
+                             , glblasMemory_t c, const int ldc )
+{
+    _glblas_internal_buffer *device_c = get_buffer_from_handle(c);
+    GLBLAS_ASSERT_STATUS(device_c, GLBLAS_STATUS_INVALID_VALUE);
 
-    glViewport(0, 0, width, height);
-    glUseProgram(shaders[OP_SCOPY].program);
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, device_x->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SCOPY].program, "x"), 0);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, device_y->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SCOPY].program, "y"), 1);
-
-    glUniform2f(glGetUniformLocation(shaders[OP_SCOPY].program, "dims"), width, height);
-    glUniform1i(glGetUniformLocation(shaders[OP_SCOPY].program, "max_index"), N);
-    glUniform1i(glGetUniformLocation(shaders[OP_SCOPY].program, "incx"), incx);
-    glUniform1i(glGetUniformLocation(shaders[OP_SCOPY].program, "incy"), incy);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, device_y->framebuffer);
-    glBindVertexArray(context->VAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    _glblas_internal_scalar s_alpha, s_beta;
+    glblasStatus_t status;
+    IF_NOT_SUCCESS_RETURN(get_scalar(device_c->context, alpha, &s_alpha));
+    IF_NOT_SUCCESS_RETURN(get_scalar(device_c->context, beta, &s_beta));
 
-    return GLBLAS_STATUS_SUCCESS;
+    return glblas_sgemm(transa, transb, M, N, K, s_alpha, a, lda, b, ldb, s_beta, c, ldc);
 }
 
-// y = a*x + y
-glblasStatus_t glblasSaxpy(int N, const float alpha, const glblasMemory_t x, int incx, glblasMemory_t y, int incy)
+// batch problems of the same shape in a, b and c, stride floats apart
+static glblasStatus_t glblas_sgemm_strided_batched( glblasOperation_t transa, glblasOperation_t transb
+                                                  , int M, int N, int K, _glblas_internal_scalar alpha
+                                                  , const glblasMemory_t a, const int lda, const int strideA
+                                                  , const glblasMemory_t b, const int ldb, const int strideB, _glblas_internal_scalar beta
+                                                  , glblasMemory_t c, const int ldc, const int strideC, int batchCount )
 {
-    _glblas_internal_buffer *device_x = (_glblas_internal_buffer*)x;
-    _glblas_internal_buffer *device_y = (_glblas_internal_buffer*)y;
-    _glblas_internal_context *context = device_x->context;
-    glblasStatus_t status;
+    GLBLAS_ASSERT_STATUS(M >= 0 && N >= 0 && K >= 0 && batchCount >= 0, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(lda >= MAX(1, transa ? K : M) && ldb >= MAX(1, transb ? N : K) && ldc >= MAX(1, M), GLBLAS_STATUS_DIMENSION_OVERFLOW);
+    // problems may share a and b, but not c
+    GLBLAS_ASSERT_STATUS(strideA >= 0 && strideB >= 0 && (batchCount <= 1 || strideC >= ldc * N), GLBLAS_STATUS_INVALID_VALUE);
 
-    int width, height;
-    IF_NOT_SUCCESS_RETURN(get_op_dims(N, device_y, context, &width, &height));
+    _glblas_internal_buffer *device_a = get_buffer_from_handle(a);
+    _glblas_internal_buffer *device_b = get_buffer_from_handle(b);
+    _glblas_internal_buffer *device_c = get_buffer_from_handle(c);
 
-    glViewport(0, 0, width, height);
-    glUseProgram(shaders[OP_SAXPY].program);
+    GLBLAS_ASSERT_STATUS(device_a && device_b && device_c, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(device_a->context == device_c->context && device_b->context == device_c->context, GLBLAS_STATUS_INVALID_VALUE);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, device_x->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SAXPY].program, "x"), 0);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, device_y->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SAXPY].program, "y"), 1);
+    _glblas_internal_context *context = device_c->context;
 
-    glUniform1f(glGetUniformLocation(shaders[OP_SAXPY].program, "alpha"), alpha);
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
 
-    glUniform2f(glGetUniformLocation(shaders[OP_SAXPY].program, "dims"), width, height);
-    glUniform1i(glGetUniformLocation(shaders[OP_SAXPY].program, "max_index"), N);
-    glUniform1i(glGetUniformLocation(shaders[OP_SAXPY].program, "incx"), incx);
-    glUniform1i(glGetUniformLocation(shaders[OP_SAXPY].program, "incy"), incy);
+    if (M == 0 || N == 0 || batchCount == 0)
+        return GLBLAS_STATUS_SUCCESS;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, device_y->framebuffer);
-    glBindVertexArray(context->VAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    sgemm_batched_buffers(context, transa, transb, M, N, K, alpha, device_a, 0, lda, strideA, device_b, 0, ldb, strideB, beta, device_c, 0, ldc, strideC, batchCount);
 
     return GLBLAS_STATUS_SUCCESS;
 }
 
-static void glblas_sdotv2_mul(int N, const glblasMemory_t x, int incx, glblasMemory_t y, int incy)
+glblasStatus_t glblasSgemmStridedBatched( glblasOperation_t transa, glblasOperation_t transb
+                                        , int M, int N, int K, const float alpha
+                                        , const glblasMemory_t a, const int lda, const int strideA
+                                        , const glblasMemory_t b, const int ldb, const int strideB, const float beta
+                                        , glblasMemory_t c, const int ldc, const int strideC, int batchCount )
 {
-    _glblas_internal_buffer *device_x = (_glblas_internal_buffer*)x;
-    _glblas_internal_buffer *device_y = (_glblas_internal_buffer*)y;
-    _glblas_internal_context *context = device_x->context;
+    return glblas_sgemm_strided_batched(transa, transb, M, N, K, (_glblas_internal_scalar){ .value = alpha }, a, lda, strideA, b, ldb, strideB, (_glblas_internal_scalar){ .value = beta }, c, ldc, strideC, batchCount);
+}
 
-    int width, height;
-    get_op_dims(N, device_y, context, &width, &height);
+glblasStatus_t glblasSgemmStridedBatched_v2( glblasOperation_t transa, glblasOperation_t transb
+                                           , int M, int N, int K, const float *alpha
+                                           , const glblasMemory_t a, const int lda, const int strideA
+                                           , const glblasMemory_t b, const int ldb, const int strideB, const float *beta
+                                           , glblasMemory_t c, const int ldc, const int strideC, int batchCount )
+{
+    _glblas_internal_buffer *device_c = get_buffer_from_handle(c);
+    GLBLAS_ASSERT_STATUS(device_c, GLBLAS_STATUS_INVALID_VALUE);
 
-    glViewport(0, 0, width, height);
-    glUseProgram(shaders[OP_SDOTV2_MUL].program);
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, device_x->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SDOTV2_MUL].program, "x"), 0);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, device_y->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SDOTV2_MUL].program, "y"), 1);
-
-    glUniform2f(glGetUniformLocation(shaders[OP_SDOTV2_MUL].program, "dims"), width, height);
-    glUniform1i(glGetUniformLocation(shaders[OP_SDOTV2_MUL].program, "max_index"), N);
-    glUniform1i(glGetUniformLocation(shaders[OP_SDOTV2_MUL].program, "incx"), incx);
-    glUniform1i(glGetUniformLocation(shaders[OP_SDOTV2_MUL].program, "incy"), incy);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, device_y->framebuffer);
-    glBindVertexArray(context->VAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    _glblas_internal_scalar s_alpha, s_beta;
+    glblasStatus_t status;
+    IF_NOT_SUCCESS_RETURN(get_scalar(device_c->context, alpha, &s_alpha));
+    IF_NOT_SUCCESS_RETURN(get_scalar(device_c->context, beta, &s_beta));
+
+    return glblas_sgemm_strided_batched(transa, transb, M, N, K, s_alpha, a, lda, strideA, b, ldb, strideB, s_beta, c, ldc, strideC, batchCount);
 }
 
-static void glblas_sdotv2_sum(int N, glblasMemory_t result, const glblasMemory_t x, int incx)
+/*
+ * batch operands in separate buffers are packed into one scratch buffer each,
+ * problems a texel aligned span apart, so the whole batch is still one
+ * strided draw or dispatch. an operand that names the same buffer for every
+ * problem is used in place with stride 0. c is packed in and copied back out
+ * span by span, which leaves its padding rows as they were. the copies are the
+ * price of separate buffers, glblasSgemmStridedBatched avoids them.
+ */
+static _glblas_internal_buffer *batch_pack( _glblas_internal_context *context, _glblas_internal_buffer *const *buffers
+                                          , int span, int min_stride, int batch, bool copy_in, int *stride )
 {
-    //GLBLAS_ASSERT(N % FLOATS_PER_PIXEL == 0, "N (%d) must be divisible by 2\n", N); // to-do: maybe support?
+    bool shared = true;
+    for (int p = 1; p < batch && shared; p++)
+        shared = buffers[p] == buffers[0];
 
-    _glblas_internal_buffer *device_x = (_glblas_internal_buffer*)x;
-    _glblas_internal_buffer *device_result = (_glblas_internal_buffer*)result;
-    _glblas_internal_context *context = device_x->context;
+    if (shared && !copy_in) {
+        *stride = 0;
+        return buffers[0];
+    }
 
-    int width, height;
-    get_op_dims(N, device_x, context, &width, &height);
+    *stride = (min_stride + FLOATS_PER_PIXEL - 1) / FLOATS_PER_PIXEL * FLOATS_PER_PIXEL;
+    _glblas_internal_buffer *packed = scratch_acquire(context, (size_t)*stride * batch * sizeof(float));
 
-    _glblas_internal_buffer *temp = glblasMalloc(device_x->context, N * sizeof(float));
-    glblasScopy(N, x, 1, temp, 1);
+    for (int p = 0; p < batch; p++)
+        copy_buffer(packed, (size_t)p * *stride * sizeof(float), buffers[p], 0, (size_t)span * sizeof(float));
 
-    glblasSync();
+    return packed;
+}
 
-    for (int tN = N / 2; tN != 0; tN /= 2) {
-        if (tN < 4)
-            tN = 1;
+static glblasStatus_t glblas_sgemm_batched( glblasOperation_t transa, glblasOperation_t transb
+                                          , int M, int N, int K, _glblas_internal_scalar alpha
+                                          , const glblasMemory_t a[], const int lda
+                                          , const glblasMemory_t b[], const int ldb, _glblas_internal_scalar beta
+                                          , glblasMemory_t c[], const int ldc, int batchCount )
+{
+    GLBLAS_ASSERT_STATUS(M >= 0 && N >= 0 && K >= 0 && batchCount >= 0, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(lda >= MAX(1, transa ? K : M) && ldb >= MAX(1, transb ? N : K) && ldc >= MAX(1, M), GLBLAS_STATUS_DIMENSION_OVERFLOW);
 
-        glViewport(0, 0, width, height);
-        glUseProgram(shaders[OP_SDOTV2_SUM].program);
+    if (batchCount == 0)
+        return GLBLAS_STATUS_SUCCESS;
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, temp->texture_colorbuffer);
-        glUniform1i(glGetUniformLocation(shaders[OP_SDOTV2_SUM].program, "x"), 0);
+    GLBLAS_ASSERT_STATUS(a && b && c, GLBLAS_STATUS_INVALID_VALUE);
 
-        glUniform2f(glGetUniformLocation(shaders[OP_SDOTV2_SUM].program, "dims"), width, height);
-        glUniform1i(glGetUniformLocation(shaders[OP_SDOTV2_SUM].program, "max_index"), tN);
-        glUniform1i(glGetUniformLocation(shaders[OP_SDOTV2_SUM].program, "incx"), incx);
+    _glblas_internal_buffer **device_a = malloc(3 * batchCount * sizeof(*device_a));
+    GLBLAS_ASSERT_STATUS(device_a, GLBLAS_STATUS_ALLOC_FAILED);
+    _glblas_internal_buffer **device_b = device_a + batchCount;
+    _glblas_internal_buffer **device_c = device_b + batchCount;
 
-        glBindFramebuffer(GL_FRAMEBUFFER, temp->framebuffer);
-        glBindVertexArray(context->VAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    _glblas_internal_context *context = NULL;
+    bool valid = true;
 
-        glblasSync();
+    for (int p = 0; p < batchCount && valid; p++) {
+        device_a[p] = get_buffer_from_handle(a[p]);
+        device_b[p] = get_buffer_from_handle(b[p]);
+        device_c[p] = get_buffer_from_handle(c[p]);
+
+        valid = device_a[p] && device_b[p] && device_c[p];
+        if (valid && context == NULL)
+            context = device_c[p]->context;
+        valid = valid && device_a[p]->context == context && device_b[p]->context == context && device_c[p]->context == context;
     }
 
-    glblasScopy(1, temp, 1, result, 1);
+    if (!valid) {
+        free(device_a);
+        GLBLAS_ASSERT_STATUS(false, GLBLAS_STATUS_INVALID_VALUE);
+    }
 
-    glblasFree(temp);
-}
+    if (!make_current(context)) {
+        free(device_a);
+        GLBLAS_ASSERT_STATUS(false, GLBLAS_STATUS_EXECUTION_FAILED);
+    }
 
-// dot product
-glblasStatus_t glblasSdot(int N, glblasMemory_t result, const glblasMemory_t x, int incx, const glblasMemory_t y, int incy)
-{
-    _glblas_internal_buffer *device_y = (_glblas_internal_buffer*)y;
-    _glblas_internal_buffer *savedy = glblasMalloc(device_y->context, N * sizeof(float));
-    glblasStatus_t status;
+    if (M == 0 || N == 0) {
+        free(device_a);
+        return GLBLAS_STATUS_SUCCESS;
+    }
+
+    int span_a = ((transa ? M : K) - 1) * lda + (transa ? K : M);
+    int span_b = ((transb ? K : N) - 1) * ldb + (transb ? N : K);
+    int span_c = (N - 1) * ldc + M;
+
+    // k == 0 leaves nothing to read in a and b
+    int stride_a = 0, stride_b = 0, stride_c;
+    _glblas_internal_buffer *packed_a = K > 0 ? batch_pack(context, device_a, span_a, span_a, batchCount, false, &stride_a) : device_a[0];
+    _glblas_internal_buffer *packed_b = K > 0 ? batch_pack(context, device_b, span_b, span_b, batchCount, false, &stride_b) : device_b[0];
+    // the kernels find the problem from the c element, so c problems are whole ldc * N apart
+    _glblas_internal_buffer *packed_c = batch_pack(context, device_c, span_c, ldc * N, batchCount, true, &stride_c);
 
-    IF_NOT_SUCCESS_RETURN(glblasScopy(N, y, 1, savedy, 1));
+    sgemm_batched_buffers(context, transa, transb, M, N, K, alpha, packed_a, 0, lda, stride_a, packed_b, 0, ldb, stride_b, beta, packed_c, 0, ldc, stride_c, batchCount);
 
-    glblasSync();
+    for (int p = 0; p < batchCount; p++)
+        copy_buffer(device_c[p], 0, packed_c, (size_t)p * stride_c * sizeof(float), (size_t)span_c * sizeof(float));
 
-    glblas_sdotv2_mul(N, x, incx, savedy, incy);
-    glblas_sdotv2_sum(N, result, savedy, 1);
+    if (packed_a != device_a[0])
+        scratch_release(packed_a);
+    if (packed_b != device_b[0])
+        scratch_release(packed_b);
+    scratch_release(packed_c);
 
-    glblasFree(savedy);
+    free(device_a);
 
     return GLBLAS_STATUS_SUCCESS;
 }
 
-// dot product
-// void glblasSdot(int N, glblasMemory_t result, const glblasMemory_t x, int incx, const glblasMemory_t y, int incy)
-// {
-//     _glblas_internal_buffer *device_x = (_glblas_internal_buffer*)x;
-//     _glblas_internal_buffer *device_y = (_glblas_internal_buffer*)y;
-//     _glblas_internal_buffer *device_result = (_glblas_internal_buffer*)result;
-//     _glblas_internal_context *context = device_x->context;
-
-//     int width, height;
-//     if (N == device_y->size / sizeof(float)) {
-//         width = device_y->width;
-//         height = device_y->height;
-//     }
-//     else {
-//         get_texture_dimensions(N * sizeof(float), context->pbuffer_width, context->pbuffer_height, &width, &height, NULL);
-//     }
-
-//     glViewport(0, 0, width, height);
-//     glUseProgram(shaders[OP_SDOT].program);
-
-//     glActiveTexture(GL_TEXTURE0);
-//     glBindTexture(GL_TEXTURE_2D, device_x->texture_colorbuffer);
-//     glUniform1i(glGetUniformLocation(shaders[OP_SDOT].program, "x"), 0);
-//     glActiveTexture(GL_TEXTURE1);
-//     glBindTexture(GL_TEXTURE_2D, device_y->texture_colorbuffer);
-//     glUniform1i(glGetUniformLocation(shaders[OP_SDOT].program, "y"), 1);
-
-//     glUniform2f(glGetUniformLocation(shaders[OP_SDOT].program, "dims"), width, height);
-//     glUniform1i(glGetUniformLocation(shaders[OP_SDOT].program, "max_index"), N);
-//     glUniform1i(glGetUniformLocation(shaders[OP_SDOT].program, "incx"), incx);
-//     glUniform1i(glGetUniformLocation(shaders[OP_SDOT].program, "incy"), incy);
-
-//     glBindFramebuffer(GL_FRAMEBUFFER, device_result->framebuffer);
-//     glActiveTexture(GL_TEXTURE2);
-//     glBindTexture(GL_TEXTURE_2D, device_result->texture_colorbuffer);
-//     glBindVertexArray(context->VAO);
-//     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-// }
+glblasStatus_t glblasSgemmBatched( glblasOperation_t transa, glblasOperation_t transb
+                                 , int M, int N, int K, const float alpha
+                                 , const glblasMemory_t a[], const int lda
+                                 , const glblasMemory_t b[], const int ldb, const float beta
+                                 , glblasMemory_t c[], const int ldc, int batchCount )
+{
+    return glblas_sgemm_batched(transa, transb, M, N, K, (_glblas_internal_scalar){ .value = alpha }, a, lda, b, ldb, (_glblas_internal_scalar){ .value = beta }, c, ldc, batchCount);
+}
 
-// sum of abs values
-glblasStatus_t glblasSasum(int N, glblasMemory_t result, const glblasMemory_t x, int incx)
+glblasStatus_t glblasSgemmBatched_v2( glblasOperation_t transa, glblasOperation_t transb
+                                    , int M, int N, int K, const float *alpha
+                                    , const glblasMemory_t a[], const int lda
+                                    , const glblasMemory_t b[], const int ldb, const float *beta
+                                    , glblasMemory_t c[], const int ldc, int batchCount )
 {
-    // GLBLAS_ASSERT(N % FLOATS_PER_PIXEL == 0, "N (%d) must be divisible by 2\n", N); // to-do: maybe support?
+    // nothing to run, but the arguments are still checked; there's no c[0] to resolve the scalars against
+    if (batchCount == 0)
+        return glblas_sgemm_batched(transa, transb, M, N, K, (_glblas_internal_scalar){ 0 }, a, lda, b, ldb, (_glblas_internal_scalar){ 0 }, c, ldc, batchCount);
 
-    _glblas_internal_buffer *device_x = (_glblas_internal_buffer*)x;
-    _glblas_internal_buffer *device_result = (_glblas_internal_buffer*)result;
-    _glblas_internal_context *context = device_x->context;
+    GLBLAS_ASSERT_STATUS(batchCount > 0 && c, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_buffer *device_c = get_buffer_from_handle(c[0]);
+    GLBLAS_ASSERT_STATUS(device_c, GLBLAS_STATUS_INVALID_VALUE);
+
+    _glblas_internal_scalar s_alpha, s_beta;
     glblasStatus_t status;
+    IF_NOT_SUCCESS_RETURN(get_scalar(device_c->context, alpha, &s_alpha));
+    IF_NOT_SUCCESS_RETURN(get_scalar(device_c->context, beta, &s_beta));
 
-    int width, height;
-    IF_NOT_SUCCESS_RETURN(get_op_dims(N, device_x, context, &width, &height));
+    return glblas_sgemm_batched(transa, transb, M, N, K, s_alpha, a, lda, b, ldb, s_beta, c, ldc, batchCount);
+}
+
+// symmetric rank-k update of the uplo triangle of c, c is N by N
+static glblasStatus_t glblas_ssyrk( glblasFillMode_t uplo, glblasOperation_t trans
+                                  , int N, int K, _glblas_internal_scalar alpha
+                                  , const glblasMemory_t a, const int lda, _glblas_internal_scalar beta
+                                  , glblasMemory_t c, const int ldc )
+{
+    GLBLAS_ASSERT_STATUS(N >= 0 && K >= 0, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(lda >= MAX(1, trans ? K : N) && ldc >= MAX(1, N), GLBLAS_STATUS_DIMENSION_OVERFLOW);
 
-    _glblas_internal_buffer *temp = glblasMalloc(device_x->context, N * sizeof(float));
-    glblasScopy(N, x, 1, temp, 1);
+    _glblas_internal_buffer *device_a = get_buffer_from_handle(a);
+    _glblas_internal_buffer *device_c = get_buffer_from_handle(c);
 
-    glblasSync();
+    GLBLAS_ASSERT_STATUS(device_a && device_c, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(device_a->context == device_c->context, GLBLAS_STATUS_INVALID_VALUE);
 
-    for (int tN = N / 2; tN != 0; tN /= 2) {
-        if (tN < 4)
-            tN = 1;
+    _glblas_internal_context *context = device_c->context;
 
-        glViewport(0, 0, width, height);
-        glUseProgram(shaders[OP_SASUM].program);
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, temp->texture_colorbuffer);
-        glUniform1i(glGetUniformLocation(shaders[OP_SASUM].program, "x"), 0);
+    if (N == 0)
+        return GLBLAS_STATUS_SUCCESS;
 
-        glUniform2f(glGetUniformLocation(shaders[OP_SASUM].program, "dims"), width, height);
-        glUniform1i(glGetUniformLocation(shaders[OP_SASUM].program, "max_index"), tN);
-        glUniform1i(glGetUniformLocation(shaders[OP_SASUM].program, "incx"), incx);
+    int variant = scalar_variant(&alpha, &beta) | (trans ? VARIANT_A_TRANS : 0);
+
+    _glblas_internal_params params = {
+        .m = N,
+        .n = N,
+        .k = K,
+        .lda = lda,
+        .ldc = ldc,
+        .uplo = uplo == GLBLAS_FILL_MODE_UPPER,
+        .alpha = alpha.value,
+        .beta = beta.value,
+        .scalar_mode = bind_scalars(context, &alpha, &beta),
+    };
 
-        glBindFramebuffer(GL_FRAMEBUFFER, temp->framebuffer);
-        glBindVertexArray(context->VAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    state_bind_texture(context, 0, device_a->texture_colorbuffer);
 
-        glblasSync();
+    // same tile as sgemm, whole texels of c
+    if (context->backend == GLBLAS_BACKEND_COMPUTE && ldc % FLOATS_PER_PIXEL == 0) {
+        dispatch(context, OP_CS_SSYRK, variant, device_c, (N + CS_SGEMM_TILE_N - 1) / CS_SGEMM_TILE_N, (N + CS_SGEMM_TILE_M - 1) / CS_SGEMM_TILE_M, &params);
+        return GLBLAS_STATUS_SUCCESS;
     }
 
-    glblasScopy(1, temp, 1, result, 1);
-    glblasFree(temp);
+    if (lda % FLOATS_PER_PIXEL == 0 && ldc % FLOATS_PER_PIXEL == 0)
+        variant |= VARIANT_UNIT_STRIDE;
+
+    state_bind_texture(context, 2, device_c->texture_colorbuffer);
+    draw(context, OP_SSYRK, variant, device_c, texel_count(ldc * N), &params);
 
     return GLBLAS_STATUS_SUCCESS;
 }
 
-// matrix matrix multiply
-glblasStatus_t glblasSgemm( glblasOperation_t transa, glblasOperation_t transb
-                          , int M, int N, int K, const float alpha
-                          , const glblasMemory_t a, const int lda
-                          , const glblasMemory_t b, const int ldb, const float beta
+glblasStatus_t glblasSsyrk( glblasFillMode_t uplo, glblasOperation_t trans
+                          , int N, int K, const float alpha
+                          , const glblasMemory_t a, const int lda, const float beta
                           , glblasMemory_t c, const int ldc )
 {
-    // GLBLAS_ASSERT(M >= 0 && N >= 0 && K >= 0, "M, N, K must be 0 or positive\n"); // lol
-    // GLBLAS_ASSERT(lda >= MAX(1, transa ? K : M), "lda out of range\n");
-    // GLBLAS_ASSERT(ldb >= MAX(1, transb ? N : K), "ldb out of range\n");
-    // GLBLAS_ASSERT(ldc >= MAX(1, M), "ldc out of range\n");
+    return glblas_ssyrk(uplo, trans, N, K, (_glblas_internal_scalar){ .value = alpha }, a, lda, (_glblas_internal_scalar){ .value = beta }, c, ldc);
+}
 
-    GLBLAS_ASSERT_STATUS(M >= 0 && N >= 0 && K >= 0, GLBLAS_STATUS_INVALID_VALUE);
-    GLBLAS_ASSERT_STATUS(lda >= MAX(1, transa ? K : M) || ldb >= MAX(1, transb ? N : K) || ldc >= MAX(1, M), GLBLAS_STATUS_DIMENSION_OVERFLOW);
+glblasStatus_t glblasSsyrk_v2( glblasFillMode_t uplo, glblasOperation_t trans
+                             , int N, int K, const float *alpha
+                             , const glblasMemory_t a, const int lda, const float *beta
+                             , glblasMemory_t c, const int ldc )
+{
+    _glblas_internal_buffer *device_c = get_buffer_from_handle(c);
+    GLBLAS_ASSERT_STATUS(device_c, GLBLAS_STATUS_INVALID_VALUE);
 
-    _glblas_internal_buffer *device_a = (_glblas_internal_buffer*)a;
-    _glblas_internal_buffer *device_b = (_glblas_internal_buffer*)b;
-    _glblas_internal_buffer *device_c = (_glblas_internal_buffer*)c;
-    _glblas_internal_context *context = device_c->context;
+    _glblas_internal_scalar s_alpha, s_beta;
     glblasStatus_t status;
+    IF_NOT_SUCCESS_RETURN(get_scalar(device_c->context, alpha, &s_alpha));
+    IF_NOT_SUCCESS_RETURN(get_scalar(device_c->context, beta, &s_beta));
 
-    int width, height;
-    IF_NOT_SUCCESS_RETURN(get_op_dims(M * N, device_c, context, &width, &height));
-
-    glViewport(0, 0, width, height);
-    glUseProgram(shaders[OP_SGEMM].program);
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, device_a->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM].program, "a"), 0);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, device_b->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM].program, "b"), 1);
-    glActiveTexture(GL_TEXTURE2);
-    glBindTexture(GL_TEXTURE_2D, device_c->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM].program, "c"), 2);
-
-    glUniform2f(glGetUniformLocation(shaders[OP_SGEMM].program, "dims"), width, height);
-    glUniform2f(glGetUniformLocation(shaders[OP_SGEMM].program, "adims"), device_a->width, device_a->height);
-    glUniform2f(glGetUniformLocation(shaders[OP_SGEMM].program, "bdims"), device_b->width, device_b->height);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM].program, "max_index"), M * N);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM].program, "m"), M);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM].program, "n"), N);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM].program, "k"), K);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM].program, "lda"), lda);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM].program, "ldb"), ldb);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM].program, "ldc"), ldc);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM].program, "aT"), transa);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM].program, "bT"), transb);
-    glUniform1f(glGetUniformLocation(shaders[OP_SGEMM].program, "alpha"), alpha);
-    glUniform1f(glGetUniformLocation(shaders[OP_SGEMM].program, "beta"), beta);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, device_c->framebuffer);
-    glBindVertexArray(context->VAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-
-    return GLBLAS_STATUS_SUCCESS;
+    return glblas_ssyrk(uplo, trans, N, K, s_alpha, a, lda, s_beta, c, ldc);
 }
 
-static void glblas_sgemm4x4_reorder(int N, const glblasMemory_t x, glblasMemory_t y)
+/*
+ * blocked triangular solve. one pass inverts the TRSM_BLOCK wide diagonal
+ * blocks of op(a) into scratch, b is copied to a scratch buffer s holding the
+ * right hand sides. each step then goes through sgemm twice: the block's rows
+ * (left) or columns (right) of b are its inverse applied to s, and their
+ * contribution is subtracted from the rest of s still to be solved. the first
+ * step applies alpha, to the block and as the beta of the rest of s, so later
+ * steps read already scaled sides. b and s are never read and written by the
+ * same pass and everything stays on the device.
+ */
+static glblasStatus_t glblas_strsm( glblasSideMode_t side, glblasFillMode_t uplo, glblasOperation_t trans, glblasDiagType_t diag
+                                  , int M, int N, _glblas_internal_scalar alpha
+                                  , const glblasMemory_t a, const int lda
+                                  , glblasMemory_t b, const int ldb )
 {
-    _glblas_internal_buffer *device_x = (_glblas_internal_buffer*)x;
-    _glblas_internal_buffer *device_y = (_glblas_internal_buffer*)y;
-    _glblas_internal_context *context = device_x->context;
+    bool left = side == GLBLAS_SIDE_LEFT;
+    int order = left ? M : N;
 
-    int width, height;
-    get_op_dims(N, device_y, context, &width, &height);
+    GLBLAS_ASSERT_STATUS(M >= 0 && N >= 0, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(lda >= MAX(1, order) && ldb >= MAX(1, M), GLBLAS_STATUS_DIMENSION_OVERFLOW);
 
-    glViewport(0, 0, width, height);
-    glUseProgram(shaders[OP_SGEMM4x4_R].program);
+    _glblas_internal_buffer *device_a = get_buffer_from_handle(a);
+    _glblas_internal_buffer *device_b = get_buffer_from_handle(b);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, device_x->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4_R].program, "x"), 0);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, device_y->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4_R].program, "y"), 1);
+    GLBLAS_ASSERT_STATUS(device_a && device_b, GLBLAS_STATUS_INVALID_VALUE);
+    GLBLAS_ASSERT_STATUS(device_a->context == device_b->context, GLBLAS_STATUS_INVALID_VALUE);
 
-    glUniform2f(glGetUniformLocation(shaders[OP_SGEMM4x4_R].program, "dims"), width, height);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4_R].program, "max_index"), N);
+    _glblas_internal_context *context = device_b->context;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, device_y->framebuffer);
-    glBindVertexArray(context->VAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    GLBLAS_ASSERT_STATUS(make_current(context), GLBLAS_STATUS_EXECUTION_FAILED);
+
+    if (M == 0 || N == 0)
+        return GLBLAS_STATUS_SUCCESS;
+
+    // op(a) lower: left solves go down the rows, right solves go back from the last column
+    bool op_lower = (uplo == GLBLAS_FILL_MODE_LOWER) != (trans != GLBLAS_OP_N);
+    bool forward = left == op_lower;
+
+    int blocks = (order + TRSM_BLOCK - 1) / TRSM_BLOCK;
+    int block_size = TRSM_BLOCK * TRSM_BLOCK;
+    int span = (N - 1) * ldb + M;
+
+    // acquire before binding, creating scratch storage rebinds the active unit
+    _glblas_internal_buffer *inverse = scratch_acquire(context, (size_t)blocks * block_size * sizeof(float));
+    _glblas_internal_buffer *rhs = scratch_acquire(context, (size_t)span * sizeof(float));
+    copy_buffer(rhs, 0, device_b, 0, (size_t)span * sizeof(float));
+
+    _glblas_internal_params params = {
+        .max_index = blocks * block_size,
+        .m = order,
+        .lda = lda,
+        .uplo = !op_lower,
+        .diag = diag == GLBLAS_DIAG_UNIT,
+    };
+    int variant = trans ? VARIANT_A_TRANS : 0;
+
+    state_bind_texture(context, 0, device_a->texture_colorbuffer);
+
+    if (context->backend == GLBLAS_BACKEND_COMPUTE)
+        dispatch_linear(context, OP_CS_STRSM, variant, inverse, blocks, &params);
+    else
+        draw(context, OP_STRSM, variant, inverse, texel_count(params.max_index), &params);
+
+    _glblas_internal_scalar zero = { .value = 0.0f };
+    _glblas_internal_scalar one = { .value = 1.0f };
+    _glblas_internal_scalar minus_one = { .value = -1.0f };
+
+    for (int s = 0; s < blocks; s++) {
+        int blk = forward ? s : blocks - 1 - s;
+        int k0 = blk * TRSM_BLOCK;
+        int nb = MIN(TRSM_BLOCK, order - k0);
+        _glblas_internal_scalar scale = s == 0 ? alpha : one;
+
+        // the rows or columns still to be solved
+        int r0 = forward ? k0 + nb : 0;
+        int rn = forward ? order - r0 : k0;
+
+        if (left) {
+            sgemm_buffers(context, GLBLAS_OP_N, GLBLAS_OP_N, nb, N, nb, scale, inverse, blk * block_size, TRSM_BLOCK, rhs, k0, ldb, zero, device_b, k0, ldb);
+            if (rn > 0)
+                sgemm_buffers(context, trans, GLBLAS_OP_N, rn, N, nb, minus_one, device_a, trans ? r0 * lda + k0 : k0 * lda + r0, lda, device_b, k0, ldb, scale, rhs, r0, ldb);
+        }
+        else {
+            sgemm_buffers(context, GLBLAS_OP_N, GLBLAS_OP_N, M, nb, nb, scale, rhs, k0 * ldb, ldb, inverse, blk * block_size, TRSM_BLOCK, zero, device_b, k0 * ldb, ldb);
+            if (rn > 0)
+                sgemm_buffers(context, GLBLAS_OP_N, trans, M, rn, nb, minus_one, device_b, k0 * ldb, ldb, device_a, trans ? k0 * lda + r0 : r0 * lda + k0, lda, scale, rhs, r0 * ldb, ldb);
+        }
+    }
+
+    scratch_release(rhs);
+    scratch_release(inverse);
+
+    return GLBLAS_STATUS_SUCCESS;
 }
 
-glblasStatus_t glblasSgemm4x4( glblasOperation_t transa, glblasOperation_t transb
-                             , int M, int N, int K, const float alpha
+glblasStatus_t glblasStrsm( glblasSideMode_t side, glblasFillMode_t uplo, glblasOperation_t trans, glblasDiagType_t diag
+                          , int M, int N, const float alpha
+                          , const glblasMemory_t a, const int lda
+                          , glblasMemory_t b, const int ldb )
+{
+    return glblas_strsm(side, uplo, trans, diag, M, N, (_glblas_internal_scalar){ .value = alpha }, a, lda, b, ldb);
+}
+
+glblasStatus_t glblasStrsm_v2( glblasSideMode_t side, glblasFillMode_t uplo, glblasOperation_t trans, glblasDiagType_t diag
+                             , int M, int N, const float *alpha
                              , const glblasMemory_t a, const int lda
-                             , const glblasMemory_t b, const int ldb, const float beta
-                             , glblasMemory_t c, const int ldc )
+                             , glblasMemory_t b, const int ldb )
 {
-    // GLBLAS_ASSERT(M % 4 == 0 && N % 4 == 0 && K % 4 == 0 && M == N && M == K, "M, N, K must be multiples of 4 and form a square\n");
-    // GLBLAS_ASSERT(M >= 0 && N >= 0 && K >= 0, "M, N, K must be 0 or positive\n"); // lol
-    // GLBLAS_ASSERT(lda >= MAX(1, transa ? K : M), "lda out of range\n");
-    // GLBLAS_ASSERT(ldb >= MAX(1, transb ? N : K), "ldb out of range\n");
-    // GLBLAS_ASSERT(ldc >= MAX(1, M), "ldc out of range\n");
-    
-    GLBLAS_ASSERT_STATUS(M % 4 == 0 && N % 4 == 0 && K % 4 == 0 && M == N && M == K && M >= 0 && N >= 0 && K >= 0, GLBLAS_STATUS_INVALID_VALUE);
-    GLBLAS_ASSERT_STATUS(lda >= MAX(1, transa ? K : M) || ldb >= MAX(1, transb ? N : K) || ldc >= MAX(1, M), GLBLAS_STATUS_DIMENSION_OVERFLOW);
+    _glblas_internal_buffer *device_b = get_buffer_from_handle(b);
+    GLBLAS_ASSERT_STATUS(device_b, GLBLAS_STATUS_INVALID_VALUE);
 
-    _glblas_internal_buffer *device_a = (_glblas_internal_buffer*)a;
-    _glblas_internal_buffer *device_b = (_glblas_internal_buffer*)b;
-    _glblas_internal_buffer *device_c = (_glblas_internal_buffer*)c;
-    _glblas_internal_context *context = device_c->context;
+    _glblas_internal_scalar s_alpha;
     glblasStatus_t status;
+    IF_NOT_SUCCESS_RETURN(get_scalar(device_b->context, alpha, &s_alpha));
 
-    int width, height;
-    IF_NOT_SUCCESS_RETURN(get_op_dims(M * N, device_c, context, &width, &height));
-
-    _glblas_internal_buffer *reordered_a = transa ? NULL : glblasMalloc(context, M * K * sizeof(float));
-    _glblas_internal_buffer *reordered_b = transb ? glblasMalloc(context, K * N * sizeof(float)) : NULL;
-
-    if (!transa)
-        glblas_sgemm4x4_reorder(M * K, device_a, reordered_a);
-    if (transb)
-        glblas_sgemm4x4_reorder(K * N, device_b, reordered_b);
+    return glblas_strsm(side, uplo, trans, diag, M, N, s_alpha, a, lda, b, ldb);
+}
 
-    _glblas_internal_buffer *u_a = transa ? device_a : reordered_a;
-    _glblas_internal_buffer *u_b = transb ? reordered_b : device_b;
+// op(a)*x = b is x^T*op(a)^T = b^T, a one row right hand side strided by incx
+glblasStatus_t glblasStrsv( glblasFillMode_t uplo, glblasOperation_t trans, glblasDiagType_t diag
+                          , int N, const glblasMemory_t a, const int lda
+                          , glblasMemory_t x, int incx )
+{
+    GLBLAS_ASSERT_STATUS(incx > 0, GLBLAS_STATUS_INVALID_VALUE);
 
-    glViewport(0, 0, width, height);
-    glUseProgram(shaders[OP_SGEMM4x4].program);
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, u_a->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "a"), 0);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, u_b->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "b"), 1);
-    glActiveTexture(GL_TEXTURE2);
-    glBindTexture(GL_TEXTURE_2D, device_c->texture_colorbuffer);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "c"), 2);
-
-    glUniform2f(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "dims"), width, height);
-    glUniform2f(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "adims"), u_a->width, u_a->height);
-    glUniform2f(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "bdims"), u_b->width, u_b->height);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "max_index"), M * N);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "m"), M);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "n"), N);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "k"), K);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "lda"), lda);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "ldb"), ldb);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "ldc"), ldc);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "aT"), transa);
-    glUniform1i(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "bT"), transb);
-    glUniform1f(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "alpha"), alpha);
-    glUniform1f(glGetUniformLocation(shaders[OP_SGEMM4x4].program, "beta"), beta);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, device_c->framebuffer);
-    glBindVertexArray(context->VAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    glblasOperation_t trans_t = trans == GLBLAS_OP_N ? GLBLAS_OP_T : GLBLAS_OP_N;
 
-    if (reordered_a != NULL)
-        glblasFree(reordered_a);
-    if (reordered_b != NULL)
-        glblasFree(reordered_b);
+    return glblas_strsm(GLBLAS_SIDE_RIGHT, uplo, trans_t, diag, 1, N, (_glblas_internal_scalar){ .value = 1.0f }, a, lda, x, incx);
+}
 
-    return GLBLAS_STATUS_SUCCESS;
+// kept for existing callers, the general sgemm covers every shape
+glblasStatus_t glblasSgemm4x4( glblasOperation_t transa, glblasOperation_t transb
+                             , int M, int N, int K, const float alpha
+                             , const glblasMemory_t a, const int lda
+                             , const glblasMemory_t b, const int ldb, const float beta
+                             , glblasMemory_t c, const int ldc )
+{
+    return glblasSgemm(transa, transb, M, N, K, alpha, a, lda, b, ldb, beta, c, ldc);
 }
\ No newline at end of file
@@ -32,6 +32,36 @@ typedef enum glblasOperation {
     GLBLAS_OP_T
 } glblasOperation_t;
 
+typedef enum glblasFillMode {
+    GLBLAS_FILL_MODE_LOWER,
+    GLBLAS_FILL_MODE_UPPER
+} glblasFillMode_t;
+
+typedef enum glblasSideMode {
+    GLBLAS_SIDE_LEFT,
+    GLBLAS_SIDE_RIGHT
+} glblasSideMode_t;
+
+typedef enum glblasDiagType {
+    GLBLAS_DIAG_NON_UNIT,
+    GLBLAS_DIAG_UNIT
+} glblasDiagType_t;
+
+typedef enum glblasPointerMode {
+    GLBLAS_POINTER_MODE_DEVICE,
+    GLBLAS_POINTER_MODE_HOST
+} glblasPointerMode_t;
+
+typedef enum glblasExecutionMode {
+    GLBLAS_EXECUTION_IMMEDIATE,
+    GLBLAS_EXECUTION_DEFERRED
+} glblasExecutionMode_t;
+
+typedef enum glblasBackend {
+    GLBLAS_BACKEND_FRAGMENT,
+    GLBLAS_BACKEND_COMPUTE
+} glblasBackend_t;
+
 typedef enum glblasStatus {
     GLBLAS_STATUS_SUCCESS,
     GLBLAS_STATUS_ALLOC_FAILED,
@@ -39,49 +69,238 @@ typedef enum glblasStatus {
     GLBLAS_STATUS_NOT_SUPPORTED,
     GLBLAS_STATUS_EXECUTION_FAILED,
     GLBLAS_STATUS_DIMENSION_OVERFLOW,
+    GLBLAS_STATUS_NOT_READY,
 } glblasStatus_t;
 
 typedef void *glblasHandle_t;
-typedef void *glblasMemory_t;
+typedef void *glblasMemory_t; // opaque handle, never dereference
+typedef void *glblasEvent_t;
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*
+ * every handle owns its own gl context, so separate handles may be used from
+ * separate threads concurrently. a single handle (and the buffers allocated
+ * from it) must only be used by one thread at a time; entry points make the
+ * handle's context current on the calling thread and leave it there. to hand a
+ * handle to another thread, call glblasRelease on the thread that used it last.
+ * buffers cannot be mixed across handles.
+ */
 glblasStatus_t glblasCreate(glblasHandle_t *handle, int width, int height);
+
+// like glblasCreate, on device `device` (0 to glblasGetDeviceCount - 1) instead of the default
+// EGL display (-1). `width` is the row width, in texels, of device buffers (0 = GL_MAX_TEXTURE_SIZE),
+// `height` is unused: buffers are limited only by GL_MAX_TEXTURE_SIZE
+glblasStatus_t glblasCreateOnDevice(glblasHandle_t *handle, int device, int width, int height);
+
+// number of EGL devices available to glblasCreateOnDevice (0 without EGL_EXT_device_enumeration)
+glblasStatus_t glblasGetDeviceCount(int *count);
+
+// device's DRM render node (or primary node), or "software"
+glblasStatus_t glblasGetDeviceName(int device, char *name, size_t size);
+
+// GLBLAS_BACKEND_COMPUTE on GL 4.3+ contexts unless GLBLAS_BACKEND=fragment is set, else GLBLAS_BACKEND_FRAGMENT
+glblasStatus_t glblasGetBackend(glblasHandle_t ctx, glblasBackend_t *backend);
+
+// glFinish on the context current on the calling thread (the last handle used), prefer glblasSynchronize
 void glblasSync();
 void glblasDestroy(glblasHandle_t ctx);
 
+// unbind ctx from the calling thread so another thread can use it
+glblasStatus_t glblasRelease(glblasHandle_t ctx);
+
+// number of redundant state changes (binds, viewport, parameter uploads) skipped so far
+glblasStatus_t glblasGetElidedBinds(glblasHandle_t ctx, size_t *count);
+
+// NULL if the buffer can't be allocated or doesn't fit in a single texture
 glblasMemory_t glblasMalloc(glblasHandle_t ctx, size_t size);
 glblasStatus_t glblasMemcpy(void *dst, void *src, size_t size, glblasMemcpyKind_t kind);
+
+// copy `size` bytes between two device buffers at the given byte offsets (multiples of 4)
+glblasStatus_t glblasMemcpyDevice(glblasMemory_t dst, size_t dst_offset, const glblasMemory_t src, size_t src_offset, size_t size);
+
+// queue a copy through pixel buffer objects and return immediately; host memory
+// written by a download is only valid once glblasMemcpyQuery/Wait report completion
+glblasStatus_t glblasMemcpyAsync(void *dst, void *src, size_t size, glblasMemcpyKind_t kind);
+
+// GLBLAS_STATUS_SUCCESS if every async copy on ctx has finished, GLBLAS_STATUS_NOT_READY otherwise
+glblasStatus_t glblasMemcpyQuery(glblasHandle_t ctx);
+
+// block until every async copy on ctx has finished
+glblasStatus_t glblasMemcpyWait(glblasHandle_t ctx);
+
+/*
+ * events mark a point in a handle's stream of work. an event belongs to the
+ * handle it was created on and must be destroyed before that handle. once an
+ * event completes, every kernel and copy (including async downloads) issued on
+ * the handle before it was recorded has finished.
+ */
+glblasStatus_t glblasEventCreate(glblasHandle_t ctx, glblasEvent_t *event);
+
+// mark the current end of the handle's stream, replacing any earlier record
+glblasStatus_t glblasEventRecord(glblasEvent_t event);
+
+// GLBLAS_STATUS_SUCCESS if the recorded work has finished (or nothing was recorded), GLBLAS_STATUS_NOT_READY otherwise; never blocks
+glblasStatus_t glblasEventQuery(glblasEvent_t event);
+
+// block until the recorded work has finished
+glblasStatus_t glblasEventSynchronize(glblasEvent_t event);
+void glblasEventDestroy(glblasEvent_t event);
+
+// block until all work issued on ctx has finished
+glblasStatus_t glblasSynchronize(glblasHandle_t ctx);
 void glblasFree(glblasMemory_t buf);
 
+// cap the device memory kept in the pool of kernel temporaries (default 64 MiB)
+glblasStatus_t glblasSetScratchLimit(glblasHandle_t ctx, size_t size);
+
+// release pooled temporaries until at most `size` bytes remain
+glblasStatus_t glblasTrimScratch(glblasHandle_t ctx, size_t size);
+
+/*
+ * where scalar results (sdot, sasum, snrm2, isamax) and the alpha/beta of the _v2 kernels
+ * live. device mode (the default, unlike cublas) takes glblasMemory_t buffers
+ * and uses their first float, so a result can feed the next kernel without a
+ * round trip; host mode takes float pointers and blocks until results land.
+ * a device scalar must not be the buffer the kernel writes.
+ */
+glblasStatus_t glblasSetPointerMode(glblasHandle_t ctx, glblasPointerMode_t mode);
+glblasStatus_t glblasGetPointerMode(glblasHandle_t ctx, glblasPointerMode_t *mode);
+
+/*
+ * in deferred mode (off by default) unit-stride sscal, saxpy and scopy calls
+ * with host scalars are recorded rather than run, and each chain of them runs
+ * as a single fused kernel that reads and writes every buffer once. a chain
+ * is flushed by glblasFlush and by any other call on the handle (copies,
+ * reductions, gemm, events, free, ...), so results are observed in order.
+ */
+glblasStatus_t glblasSetExecutionMode(glblasHandle_t ctx, glblasExecutionMode_t mode);
+glblasStatus_t glblasGetExecutionMode(glblasHandle_t ctx, glblasExecutionMode_t *mode);
+
+// run whatever deferred mode has recorded on ctx
+glblasStatus_t glblasFlush(glblasHandle_t ctx);
+
 // swap x & y
 glblasStatus_t glblasSswap(int N, glblasMemory_t x, int incx, glblasMemory_t y, int incy);
 
 // x = a*x
 glblasStatus_t glblasSscal(int N, const float alpha, glblasMemory_t x, int incx);
+glblasStatus_t glblasSscal_v2(int N, const float *alpha, glblasMemory_t x, int incx);
 
 // copy x into y
 glblasStatus_t glblasScopy(int N, const glblasMemory_t x, int incx, glblasMemory_t y, int incy);
 
 // y = a*x + y
 glblasStatus_t glblasSaxpy(int N, const float alpha, const glblasMemory_t x, int incx, glblasMemory_t y, int incy);
+glblasStatus_t glblasSaxpy_v2(int N, const float *alpha, const glblasMemory_t x, int incx, glblasMemory_t y, int incy);
+
+// x, y = c*x + s*y, c*y - s*x
+glblasStatus_t glblasSrot(int N, glblasMemory_t x, int incx, glblasMemory_t y, int incy, const float c, const float s);
+
+// x, y = h11*x + h12*y, h21*x + h22*y with h given by param = (flag, h11, h21, h12, h22) as in blas srotm
+glblasStatus_t glblasSrotm(int N, glblasMemory_t x, int incx, glblasMemory_t y, int incy, const float *param);
 
-// dot product
+// dot product, result follows the pointer mode
 glblasStatus_t glblasSdot(int N, glblasMemory_t result, const glblasMemory_t x, int incx, const glblasMemory_t y, int incy);
 
-// sum of abs values
+// sum of abs values, result follows the pointer mode
 glblasStatus_t glblasSasum(int N, glblasMemory_t result, const glblasMemory_t x, int incx);
 
+// euclidean norm of x without overflow or underflow of the intermediate sums (subnormal inputs may be flushed by the gpu)
+glblasStatus_t glblasSnrm2(int N, glblasMemory_t result, const glblasMemory_t x, int incx);
+
+/*
+ * 1-based index of the first element with the largest (isamin: smallest)
+ * absolute value, 0 if N <= 0. in host pointer mode result is an int*; in
+ * device mode the index is written to the first float of the result buffer.
+ */
+glblasStatus_t glblasIsamax(int N, glblasMemory_t result, const glblasMemory_t x, int incx);
+glblasStatus_t glblasIsamin(int N, glblasMemory_t result, const glblasMemory_t x, int incx);
+
+// matrix vector multiply, y = alpha*op(a)*x + beta*y with a M by N
+glblasStatus_t glblasSgemv( glblasOperation_t trans, int M, int N, const float alpha
+                          , const glblasMemory_t a, const int lda
+                          , const glblasMemory_t x, int incx, const float beta
+                          , glblasMemory_t y, int incy );
+glblasStatus_t glblasSgemv_v2( glblasOperation_t trans, int M, int N, const float *alpha
+                             , const glblasMemory_t a, const int lda
+                             , const glblasMemory_t x, int incx, const float *beta
+                             , glblasMemory_t y, int incy );
+
+// rank-1 update, a = alpha*x*y^T + a with a M by N
+glblasStatus_t glblasSger( int M, int N, const float alpha
+                         , const glblasMemory_t x, int incx
+                         , const glblasMemory_t y, int incy
+                         , glblasMemory_t a, const int lda );
+glblasStatus_t glblasSger_v2( int M, int N, const float *alpha
+                            , const glblasMemory_t x, int incx
+                            , const glblasMemory_t y, int incy
+                            , glblasMemory_t a, const int lda );
+
+// triangular solve op(a)*x = b, b is passed in x and overwritten, a N by N
+glblasStatus_t glblasStrsv( glblasFillMode_t uplo, glblasOperation_t trans, glblasDiagType_t diag
+                          , int N, const glblasMemory_t a, const int lda
+                          , glblasMemory_t x, int incx );
+
 // matrix matrix multiply
 glblasStatus_t glblasSgemm( glblasOperation_t transa, glblasOperation_t transb
                           , int M, int N, int K, const float alpha
                           , const glblasMemory_t a, const int lda
                           , const glblasMemory_t b, const int ldb, const float beta
                           , glblasMemory_t c, const int ldc );
+glblasStatus_t glblasSgemm_v2( glblasOperation_t transa, glblasOperation_t transb
+                             , int M, int N, int K, const float *alpha
+                             , const glblasMemory_t a, const int lda
+                             , const glblasMemory_t b, const int ldb, const float *beta
+                             , glblasMemory_t c, const int ldc );
+
+// batchCount sgemms of one shape in one launch, problem p at a + p*strideA etc. (floats); a and b strides may be 0
+glblasStatus_t glblasSgemmStridedBatched( glblasOperation_t transa, glblasOperation_t transb
+                                        , int M, int N, int K, const float alpha
+                                        , const glblasMemory_t a, const int lda, const int strideA
+                                        , const glblasMemory_t b, const int ldb, const int strideB, const float beta
+                                        , glblasMemory_t c, const int ldc, const int strideC, int batchCount );
+glblasStatus_t glblasSgemmStridedBatched_v2( glblasOperation_t transa, glblasOperation_t transb
+                                           , int M, int N, int K, const float *alpha
+                                           , const glblasMemory_t a, const int lda, const int strideA
+                                           , const glblasMemory_t b, const int ldb, const int strideB, const float *beta
+                                           , glblasMemory_t c, const int ldc, const int strideC, int batchCount );
+
+// batchCount sgemms of one shape on arrays of handles, packed into one launch (separate buffers cost a copy each)
+glblasStatus_t glblasSgemmBatched( glblasOperation_t transa, glblasOperation_t transb
+                                 , int M, int N, int K, const float alpha
+                                 , const glblasMemory_t a[], const int lda
+                                 , const glblasMemory_t b[], const int ldb, const float beta
+                                 , glblasMemory_t c[], const int ldc, int batchCount );
+glblasStatus_t glblasSgemmBatched_v2( glblasOperation_t transa, glblasOperation_t transb
+                                    , int M, int N, int K, const float *alpha
+                                    , const glblasMemory_t a[], const int lda
+                                    , const glblasMemory_t b[], const int ldb, const float *beta
+                                    , glblasMemory_t c[], const int ldc, int batchCount );
+
+// symmetric rank-k update, c = alpha*op(a)*op(a)^T + beta*c on the uplo triangle of the N by N c only
+glblasStatus_t glblasSsyrk( glblasFillMode_t uplo, glblasOperation_t trans
+                          , int N, int K, const float alpha
+                          , const glblasMemory_t a, const int lda, const float beta
+                          , glblasMemory_t c, const int ldc );
+glblasStatus_t glblasSsyrk_v2( glblasFillMode_t uplo, glblasOperation_t trans
+                             , int N, int K, const float *alpha
+                             , const glblasMemory_t a, const int lda, const float *beta
+                             , glblasMemory_t c, const int ldc );
+
+// triangular solve in place of b, op(a)*x = alpha*b (left) or x*op(a) = alpha*b (right) with b M by N
+glblasStatus_t glblasStrsm( glblasSideMode_t side, glblasFillMode_t uplo, glblasOperation_t trans, glblasDiagType_t diag
+                          , int M, int N, const float alpha
+                          , const glblasMemory_t a, const int lda
+                          , glblasMemory_t b, const int ldb );
+glblasStatus_t glblasStrsm_v2( glblasSideMode_t side, glblasFillMode_t uplo, glblasOperation_t trans, glblasDiagType_t diag
+                             , int M, int N, const float *alpha
+                             , const glblasMemory_t a, const int lda
+                             , glblasMemory_t b, const int ldb );
 
-// optimized matrix multiply
+// same as glblasSgemm, kept for existing callers
 glblasStatus_t glblasSgemm4x4( glblasOperation_t transa, glblasOperation_t transb
                              , int M, int N, int K, const float alpha
                              , const glblasMemory_t a, const int lda